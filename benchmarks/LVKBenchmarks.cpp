@@ -0,0 +1,451 @@
+/*
+ * LightweightVK
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Headless benchmarks of the core hot paths. The results are written as JSON to stdout or to the file given with --out.
+//
+//   LVKBenchmarks [--out results.json] [--device discrete|integrated|software] [--validation] [--quick]
+//
+// Any Vulkan 1.3 ICD works, including software ones like lavapipe (--device software).
+// Disable the driver's own shader cache for meaningful pipeline.create.cold numbers, e.g. MESA_SHADER_CACHE_DISABLE=true on Mesa.
+
+#include <lvk/LVK.h>
+#include <lvk/Pool.h>
+#include <lvk/vulkan/VulkanClasses.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* codeVS = R"(
+#version 460
+layout(push_constant) uniform PushConstants {
+  vec2 offset;
+} pc;
+const vec2 pos[3] = vec2[3](
+  vec2(-0.01, -0.01),
+  vec2( 0.01, -0.01),
+  vec2( 0.00,  0.01)
+);
+void main() {
+  gl_Position = vec4(pos[gl_VertexIndex] + pc.offset, 0.0, 1.0);
+}
+)";
+
+const char* codeFS = R"(
+#version 460
+layout (constant_id = 0) const uint kVariant = 0;
+layout (location=0) out vec4 out_FragColor;
+void main() {
+  out_FragColor = vec4(float(kVariant & 255u) / 255.0, 1.0, 0.0, 1.0);
+}
+)";
+
+struct BenchmarkResult {
+  std::string name;
+  double value = 0;
+  const char* unit = "";
+};
+
+struct Config {
+  const char* outFileName = nullptr;
+  lvk::HWDeviceType deviceType = lvk::HWDeviceType_Discrete;
+  bool enableValidation = false;
+  bool quick = false;
+};
+
+constexpr uint32_t kWidth = 512;
+constexpr uint32_t kHeight = 512;
+
+Config config_;
+std::vector<BenchmarkResult> results_;
+
+double getSeconds() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t scaled(uint32_t n) {
+  return config_.quick ? std::max(n / 16, 1u) : n;
+}
+
+void addResult(const std::string& name, double value, const char* unit) {
+  results_.push_back({name, value, unit});
+  fprintf(stderr, "%-40s %16.2f %s\n", name.c_str(), value, unit);
+}
+
+lvk::VulkanContext& getVulkanContext(lvk::IContext* ctx) {
+  return *static_cast<lvk::VulkanContext*>(ctx);
+}
+
+void benchmarkPool() {
+  struct BenchmarkObject;
+  using BenchmarkPool = lvk::Pool<BenchmarkObject, uint64_t>;
+
+  static_assert((1u << 20) <= BenchmarkPool::kMaxObjects);
+  const uint32_t n = scaled(1u << 20);
+
+  BenchmarkPool pool;
+  std::vector<lvk::Handle<BenchmarkObject>> handles(n);
+
+  double t = getSeconds();
+  for (uint32_t i = 0; i != n; i++) {
+    handles[i] = pool.create(uint64_t(i));
+  }
+  addResult("pool.create", n / (getSeconds() - t), "ops/s");
+
+  uint64_t sum = 0;
+  t = getSeconds();
+  for (uint32_t i = 0; i != n; i++) {
+    sum += *pool.get(handles[i]);
+  }
+  addResult("pool.get", n / (getSeconds() - t), "ops/s");
+  // checked in all builds, so the loop above cannot be optimized away
+  if (sum != uint64_t(n) * (n - 1) / 2) {
+    fprintf(stderr, "pool.get returned wrong objects\n");
+  }
+
+  t = getSeconds();
+  for (uint32_t i = 0; i != n; i++) {
+    pool.destroy(handles[i]);
+  }
+  addResult("pool.destroy", n / (getSeconds() - t), "ops/s");
+}
+
+void benchmarkShaderCompilation(lvk::IContext* ctx) {
+  const uint32_t n = scaled(64);
+
+  // glslang caches nothing between calls, so compiling the same source repeatedly measures the full cost
+  const size_t sourceSize = strlen(codeVS) + strlen(codeFS);
+
+  const double t = getSeconds();
+  for (uint32_t i = 0; i != n; i++) {
+    lvk::Holder<lvk::ShaderModuleHandle> vert = ctx->createShaderModule({codeVS, lvk::Stage_Vert, "Shader Module: benchmark (vert)"});
+    lvk::Holder<lvk::ShaderModuleHandle> frag = ctx->createShaderModule({codeFS, lvk::Stage_Frag, "Shader Module: benchmark (frag)"});
+    LVK_ASSERT(vert.valid() && frag.valid());
+  }
+  const double dt = getSeconds() - t;
+
+  addResult("shader.compile", 2 * n / dt, "shaders/s");
+  addResult("shader.compile.source", n * sourceSize / dt / 1024.0, "KB/s");
+}
+
+void benchmarkPipelineCreation(lvk::IContext* ctx) {
+  lvk::VulkanContext& vkCtx = getVulkanContext(ctx);
+
+  const uint32_t n = scaled(64);
+
+  lvk::Holder<lvk::ShaderModuleHandle> vert = ctx->createShaderModule({codeVS, lvk::Stage_Vert, "Shader Module: benchmark (vert)"});
+  lvk::Holder<lvk::ShaderModuleHandle> frag = ctx->createShaderModule({codeFS, lvk::Stage_Frag, "Shader Module: benchmark (frag)"});
+
+  // every variant is a distinct VkPipeline; the specialization data has to stay alive until the pipelines are built
+  std::vector<uint32_t> variants(n);
+
+  auto createPipelines = [&]() -> double {
+    std::vector<lvk::Holder<lvk::RenderPipelineHandle>> pipelines(n);
+    for (uint32_t i = 0; i != n; i++) {
+      variants[i] = i;
+      pipelines[i] = ctx->createRenderPipeline({
+          .smVert = vert,
+          .smFrag = frag,
+          .specInfo = {.entries = {{.constantId = 0, .size = sizeof(uint32_t)}}, .data = &variants[i], .dataSize = sizeof(uint32_t)},
+          .color = {{.format = ctx->getSwapchainFormat()}},
+          .debugName = "Pipeline: benchmark",
+      });
+    }
+    // Vulkan pipelines are created lazily on the first bind, build them here to time just the creation
+    const double t = getSeconds();
+    for (uint32_t i = 0; i != n; i++) {
+      LVK_VERIFY(vkCtx.getVkPipeline(pipelines[i]) != VK_NULL_HANDLE);
+    }
+    return getSeconds() - t;
+  };
+
+  // the first round populates the pipeline cache, the second one is served by it; the driver's on-disk shader cache is not under our
+  // control and serves the "cold" round as well from the second run onwards unless it is disabled
+  const double cold = createPipelines();
+  const double warm = createPipelines();
+
+  addResult("pipeline.create.cold", n / cold, "pipelines/s");
+  addResult("pipeline.create.warm", n / warm, "pipelines/s");
+  addResult("pipeline.cache.size", (double)vkCtx.getPipelineCacheData().size(), "bytes");
+}
+
+void benchmarkDraws(lvk::IContext* ctx) {
+  const uint32_t numFrames = scaled(32);
+  const uint32_t numDrawsPerFrame = 10000;
+
+  lvk::Holder<lvk::ShaderModuleHandle> vert = ctx->createShaderModule({codeVS, lvk::Stage_Vert, "Shader Module: benchmark (vert)"});
+  lvk::Holder<lvk::ShaderModuleHandle> frag = ctx->createShaderModule({codeFS, lvk::Stage_Frag, "Shader Module: benchmark (frag)"});
+
+  lvk::Holder<lvk::RenderPipelineHandle> pipeline = ctx->createRenderPipeline({
+      .smVert = vert,
+      .smFrag = frag,
+      .color = {{.format = ctx->getSwapchainFormat()}},
+      .debugName = "Pipeline: benchmark draws",
+  });
+
+  struct PushConstants {
+    float x, y;
+  } offset = {};
+
+  double recording = 0;
+
+  // warm up: pipeline creation and the first layout transitions should not be measured
+  for (uint32_t frame = 0; frame != numFrames + 1; frame++) {
+    const bool isWarmup = frame == 0;
+
+    lvk::TextureHandle texture = ctx->getCurrentSwapchainTexture();
+
+    const double t = getSeconds();
+
+    lvk::ICommandBuffer& buffer = ctx->acquireCommandBuffer();
+    buffer.cmdBeginRendering({.color = {{.loadOp = lvk::LoadOp_Clear, .clearColor = {0.0f, 0.0f, 0.0f, 1.0f}}}},
+                             {.color = {{.texture = texture}}});
+    buffer.cmdBindRenderPipeline(pipeline);
+    buffer.cmdBindViewport({0.0f, 0.0f, (float)kWidth, (float)kHeight, 0.0f, +1.0f});
+    buffer.cmdBindScissorRect({0, 0, kWidth, kHeight});
+    for (uint32_t i = 0; i != numDrawsPerFrame; i++) {
+      offset.x = float(i % 100) / 50.0f - 1.0f;
+      offset.y = float(i / 100 % 100) / 50.0f - 1.0f;
+      buffer.cmdPushConstants(offset);
+      buffer.cmdDraw(3);
+    }
+    buffer.cmdEndRendering();
+
+    if (!isWarmup) {
+      recording += getSeconds() - t;
+    }
+
+    ctx->submit(buffer, texture);
+
+    if (isWarmup) {
+      getVulkanContext(ctx).immediate_->waitAll();
+    }
+  }
+
+  const double t = getSeconds();
+  getVulkanContext(ctx).immediate_->waitAll();
+  const double drain = getSeconds() - t;
+
+  const double numDraws = double(numFrames) * numDrawsPerFrame;
+
+  addResult("draws.record", numDraws / recording, "draws/s");
+  // the GPU work overlaps with recording, only what is left after the last submit is added
+  addResult("draws.record+gpu", numDraws / (recording + drain), "draws/s");
+}
+
+void benchmarkStaging(lvk::IContext* ctx) {
+  lvk::VulkanContext& vkCtx = getVulkanContext(ctx);
+
+  const uint32_t numIterations = scaled(16);
+
+  // buffer uploads go through the staging buffer unless device-local memory is host-visible (UMA, software rasterizers)
+  {
+    const size_t size = 32u * 1024u * 1024u;
+    std::vector<uint8_t> data(size, 0xAB);
+
+    lvk::Holder<lvk::BufferHandle> buffer = ctx->createBuffer({
+        .usage = lvk::BufferUsageBits_Storage,
+        .storage = lvk::StorageType_Device,
+        .size = size,
+        .debugName = "Buffer: benchmark upload",
+    });
+
+    // allocate the staging buffer before measuring
+    ctx->upload(buffer, data.data(), size);
+    vkCtx.immediate_->waitAll();
+
+    const double t = getSeconds();
+    for (uint32_t i = 0; i != numIterations; i++) {
+      ctx->upload(buffer, data.data(), size);
+    }
+    vkCtx.immediate_->waitAll();
+    const double dt = getSeconds() - t;
+
+    // a direct upload is a memcpy() into the mapped buffer and is not comparable to a staged one
+    const char* name = vkCtx.useStaging_ ? "staging.upload.buffer" : "direct.upload.buffer";
+    addResult(name, double(size) * numIterations / dt / (1024.0 * 1024.0), "MB/s");
+  }
+
+  // texture downloads always go through the staging buffer and wait for the GPU
+  {
+    const uint32_t dim = 1024;
+    const size_t size = size_t(dim) * dim * 4;
+    std::vector<uint8_t> data(size, 0xCD);
+
+    lvk::Holder<lvk::TextureHandle> texture = ctx->createTexture({
+        .format = lvk::Format_RGBA_UN8,
+        .dimensions = {dim, dim},
+        .usage = lvk::TextureUsageBits_Sampled,
+        .data = data.data(),
+        .debugName = "Texture: benchmark readback",
+    });
+
+    const lvk::TextureRangeDesc range = {.dimensions = {dim, dim}};
+
+    ctx->download(texture, range, data.data());
+
+    double t = getSeconds();
+    for (uint32_t i = 0; i != numIterations; i++) {
+      ctx->upload(texture, range, data.data());
+    }
+    vkCtx.immediate_->waitAll();
+    addResult("staging.upload.texture", double(size) * numIterations / (getSeconds() - t) / (1024.0 * 1024.0), "MB/s");
+
+    t = getSeconds();
+    for (uint32_t i = 0; i != numIterations; i++) {
+      ctx->download(texture, range, data.data());
+    }
+    addResult("staging.readback.texture", double(size) * numIterations / (getSeconds() - t) / (1024.0 * 1024.0), "MB/s");
+  }
+}
+
+void benchmarkDescriptorSets(lvk::IContext* ctx) {
+  lvk::VulkanContext& vkCtx = getVulkanContext(ctx);
+
+  const uint32_t numIterations = scaled(64);
+
+  std::vector<lvk::Holder<lvk::TextureHandle>> textures;
+
+  for (uint32_t numTextures : {256u, 1024u, 4096u, 16384u}) {
+    if (config_.quick && numTextures > 1024u) {
+      break;
+    }
+
+    while (textures.size() < numTextures) {
+      textures.push_back(ctx->createTexture({
+          .format = lvk::Format_RGBA_UN8,
+          .dimensions = {1, 1},
+          .usage = lvk::TextureUsageBits_Sampled,
+          .debugName = "Texture: benchmark descriptors",
+      }));
+    }
+
+    // let the descriptor pool grow outside of the measurement
+    vkCtx.checkAndUpdateDescriptorSets();
+
+    const double t = getSeconds();
+    for (uint32_t i = 0; i != numIterations; i++) {
+      // what creating any texture or sampler does
+      vkCtx.awaitingCreation_ = true;
+      vkCtx.checkAndUpdateDescriptorSets();
+    }
+    const double dt = (getSeconds() - t) / numIterations;
+
+    addResult("descriptors.update." + std::to_string(numTextures), dt * 1000000.0, "us");
+  }
+}
+
+void writeString(FILE* file, const char* str) {
+  fputc('"', file);
+  for (const char* c = str; *c; c++) {
+    if (*c == '"' || *c == '\\') {
+      fputc('\\', file);
+    }
+    if ((unsigned char)*c >= 0x20) {
+      fputc(*c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+void writeJSON(FILE* file, lvk::IContext* ctx) {
+  const VkPhysicalDeviceProperties& props = getVulkanContext(ctx).getVkPhysicalDeviceProperties();
+
+  fprintf(file, "{\n  \"device\": ");
+  writeString(file, props.deviceName);
+  fprintf(file,
+          ",\n  \"apiVersion\": \"%u.%u.%u\",\n  \"driverVersion\": %u,\n  \"quick\": %s,\n  \"results\": [\n",
+          VK_API_VERSION_MAJOR(props.apiVersion),
+          VK_API_VERSION_MINOR(props.apiVersion),
+          VK_API_VERSION_PATCH(props.apiVersion),
+          props.driverVersion,
+          config_.quick ? "true" : "false");
+  for (size_t i = 0; i != results_.size(); i++) {
+    const BenchmarkResult& r = results_[i];
+    fprintf(file, "    {\"name\": ");
+    writeString(file, r.name.c_str());
+    fprintf(file, ", \"value\": %.3f, \"unit\": ", r.value);
+    writeString(file, r.unit);
+    fprintf(file, "}%s\n", i + 1 != results_.size() ? "," : "");
+  }
+  fprintf(file, "  ]\n}\n");
+}
+
+bool parseCommandLine(int argc, char* argv[]) {
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+      config_.outFileName = argv[++i];
+    } else if (!strcmp(argv[i], "--device") && i + 1 < argc) {
+      const char* type = argv[++i];
+      if (!strcmp(type, "discrete")) {
+        config_.deviceType = lvk::HWDeviceType_Discrete;
+      } else if (!strcmp(type, "integrated")) {
+        config_.deviceType = lvk::HWDeviceType_Integrated;
+      } else if (!strcmp(type, "software")) {
+        config_.deviceType = lvk::HWDeviceType_Software;
+      } else {
+        return false;
+      }
+    } else if (!strcmp(argv[i], "--validation")) {
+      config_.enableValidation = true;
+    } else if (!strcmp(argv[i], "--quick")) {
+      config_.quick = true;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  if (!parseCommandLine(argc, argv)) {
+    fprintf(stderr, "Usage: %s [--out results.json] [--device discrete|integrated|software] [--validation] [--quick]\n", argv[0]);
+    return 1;
+  }
+
+  std::unique_ptr<lvk::IContext> ctx = lvk::createVulkanContextHeadless(kWidth,
+                                                                        kHeight,
+                                                                        {
+                                                                            .enableValidation = config_.enableValidation,
+                                                                            .swapChainColorSpace = lvk::ColorSpace_SRGB_LINEAR,
+                                                                        },
+                                                                        config_.deviceType);
+  if (!ctx) {
+    fprintf(stderr, "Cannot create a headless Vulkan context\n");
+    return 2;
+  }
+
+  benchmarkPool();
+  benchmarkShaderCompilation(ctx.get());
+  benchmarkPipelineCreation(ctx.get());
+  benchmarkDraws(ctx.get());
+  benchmarkStaging(ctx.get());
+  benchmarkDescriptorSets(ctx.get());
+
+  FILE* file = config_.outFileName ? fopen(config_.outFileName, "w") : stdout;
+
+  if (!file) {
+    fprintf(stderr, "Cannot open %s\n", config_.outFileName);
+    return 3;
+  }
+
+  writeJSON(file, ctx.get());
+
+  if (file != stdout) {
+    fclose(file);
+  }
+
+  return 0;
+}
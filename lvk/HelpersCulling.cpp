@@ -0,0 +1,393 @@
+/*
+* LightweightVK
+*
+* This source code is licensed under the MIT license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include "HelpersCulling.h"
+
+#include <string.h>
+
+static const char* codeDepthPyramidCS = R"(
+layout (local_size_x = 16, local_size_y = 16) in;
+
+layout (set = 0, binding = 0) uniform texture2D kTextures2D[];
+layout (set = 0, binding = 2, r32f) uniform image2D kImages2D[];
+
+layout(push_constant) uniform constants {
+  uint src;
+  uint dst;
+  uint srcIsDepth; // level 0 is built from a sampled depth texture, all others from storage images
+} pc;
+
+float fetchSrc(ivec2 p) {
+  return pc.srcIsDepth > 0 ? texelFetch(kTextures2D[pc.src], p, 0).r : imageLoad(kImages2D[pc.src], p).r;
+}
+
+void main() {
+  ivec2 pos = ivec2(gl_GlobalInvocationID.xy);
+  ivec2 dstSize = imageSize(kImages2D[pc.dst]);
+
+  if (any(greaterThanEqual(pos, dstSize)))
+    return;
+
+  ivec2 srcSize = pc.srcIsDepth > 0 ? textureSize(kTextures2D[pc.src], 0) : imageSize(kImages2D[pc.src]);
+
+  // all source texels overlapping this destination texel (up to 3x3 for odd sizes)
+  ivec2 p0 = (pos * srcSize) / dstSize;
+  ivec2 p1 = min(((pos + 1) * srcSize + dstSize - 1) / dstSize, srcSize);
+
+  float depth = 0.0;
+
+  for (int y = p0.y; y < p1.y; y++)
+    for (int x = p0.x; x < p1.x; x++)
+      depth = max(depth, fetchSrc(ivec2(x, y)));
+
+  imageStore(kImages2D[pc.dst], pos, vec4(depth));
+})";
+
+static const char* codeCullingCS = R"(
+layout (local_size_x = 64) in;
+
+layout (set = 0, binding = 2, r32f) uniform image2D kImages2D[];
+
+struct Shape {
+  vec4 sphere; // xyz - center, w - radius
+  uint firstIndex;
+  uint indexCount;
+  int vertexOffset;
+  uint padding;
+};
+
+struct DrawIndexedIndirectCommand {
+  uint indexCount;
+  uint instanceCount;
+  uint firstIndex;
+  int vertexOffset;
+  uint firstInstance;
+};
+
+layout(std430, buffer_reference) readonly buffer Shapes {
+  Shape shapes[];
+};
+
+layout(std430, buffer_reference) buffer ViewData {
+  uint count[4]; // early, late
+  DrawIndexedIndirectCommand dc[]; // early commands followed by late commands
+};
+
+layout(std430, buffer_reference) buffer Flags {
+  uint drawnEarly[];
+};
+
+layout(std430, buffer_reference) readonly buffer PyramidLevels {
+  uint levels[];
+};
+
+layout(push_constant) uniform constants {
+  mat4 mvp;
+  Shapes shapes;
+  ViewData view;
+  Flags flags;
+  PyramidLevels pyramid;
+  uint numShapes;
+  uint phase; // 0 - early, 1 - late
+  uint pyramidNumLevels; // 0 - no occlusion culling
+  uint padding;
+  uvec2 pyramidSize;
+} pc;
+
+bool isInsideFrustum(vec4 sphere) {
+  // Gribb-Hartmann: the planes end up in object space
+  mat4 m = transpose(pc.mvp);
+  vec4 planes[6] = vec4[6](m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[3] + m[2], m[3] - m[2]);
+  for (int i = 0; i != 6; i++) {
+    if (dot(planes[i], vec4(sphere.xyz, 1.0)) < -sphere.w * length(planes[i].xyz))
+      return false;
+  }
+  return true;
+}
+
+bool isOccluded(vec4 sphere) {
+  if (pc.pyramidNumLevels == 0)
+    return false;
+
+  // screen-space rectangle and the nearest depth of the sphere's bounding box
+  vec2 uvMin = vec2(1.0);
+  vec2 uvMax = vec2(0.0);
+  float depthMin = 1.0;
+
+  for (int i = 0; i != 8; i++) {
+    vec3 corner = sphere.xyz + sphere.w * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+    vec4 clip = pc.mvp * vec4(corner, 1.0);
+    if (clip.w <= 0.0)
+      return false; // crosses the camera plane
+    vec3 ndc = clip.xyz / clip.w;
+    // LVK flips the viewport, so NDC y = +1 is the top row of the framebuffer
+    vec2 uv = vec2(0.5 * ndc.x + 0.5, 0.5 - 0.5 * ndc.y);
+    uvMin = min(uvMin, uv);
+    uvMax = max(uvMax, uv);
+    depthMin = min(depthMin, ndc.z);
+  }
+
+  if (depthMin <= 0.0)
+    return false;
+
+  uvMin = clamp(uvMin, vec2(0.0), vec2(1.0));
+  uvMax = clamp(uvMax, vec2(0.0), vec2(1.0));
+
+  vec2 sizeTexels = (uvMax - uvMin) * vec2(pc.pyramidSize);
+  uint firstLevel = uint(max(ceil(log2(max(max(sizeTexels.x, sizeTexels.y), 1.0))), 0.0));
+
+  // storage images cannot be indexed non-uniformly, so every invocation walks all levels
+  for (uint level = 0; level < pc.pyramidNumLevels; level++) {
+    uint tex = pc.pyramid.levels[level];
+    ivec2 size = imageSize(kImages2D[tex]);
+    if (level < firstLevel)
+      continue;
+    ivec2 p0 = clamp(ivec2(uvMin * vec2(size)), ivec2(0), size - 1);
+    ivec2 p1 = clamp(ivec2(uvMax * vec2(size)), ivec2(0), size - 1);
+    // the rectangle has to fit into 2x2 texels
+    if (p1.x - p0.x > 1 || p1.y - p0.y > 1)
+      continue;
+    float depth = max(max(imageLoad(kImages2D[tex], p0).r, imageLoad(kImages2D[tex], ivec2(p1.x, p0.y)).r),
+                      max(imageLoad(kImages2D[tex], ivec2(p0.x, p1.y)).r, imageLoad(kImages2D[tex], p1).r));
+    return depthMin > depth;
+  }
+
+  return false;
+}
+
+void main() {
+  uint id = gl_GlobalInvocationID.x;
+
+  if (id >= pc.numShapes)
+    return;
+
+  bool isEarly = pc.phase == 0;
+
+  if (!isEarly && pc.flags.drawnEarly[id] != 0)
+    return;
+
+  Shape s = pc.shapes.shapes[id];
+
+  bool isVisible = isInsideFrustum(s.sphere) && !isOccluded(s.sphere);
+
+  if (isEarly)
+    pc.flags.drawnEarly[id] = isVisible ? 1u : 0u;
+
+  if (!isVisible)
+    return;
+
+  uint slot = atomicAdd(pc.view.count[pc.phase], 1u);
+
+  pc.view.dc[pc.phase * pc.numShapes + slot] = DrawIndexedIndirectCommand(s.indexCount, 1u, s.firstIndex, s.vertexOffset, id);
+})";
+
+namespace {
+
+constexpr uint32_t kCullingLocalSize = 64;
+constexpr uint32_t kPyramidLocalSize = 16;
+// the draw counts are padded so the indirect commands which follow them stay 16-byte aligned
+constexpr size_t kCommandsOffset = 16;
+
+struct DrawIndexedIndirectCommand {
+  uint32_t indexCount;
+  uint32_t instanceCount;
+  uint32_t firstIndex;
+  int32_t vertexOffset;
+  uint32_t firstInstance;
+};
+
+struct DepthPyramidPushConstants {
+  uint32_t src;
+  uint32_t dst;
+  uint32_t srcIsDepth;
+};
+
+struct CullingPushConstants {
+  float mvp[16];
+  uint64_t shapes;
+  uint64_t view;
+  uint64_t flags;
+  uint64_t pyramid;
+  uint32_t numShapes;
+  uint32_t phase;
+  uint32_t pyramidNumLevels;
+  uint32_t padding;
+  uint32_t pyramidSize[2];
+};
+
+static_assert(sizeof(lvk::CullingShape) == 32);
+static_assert(sizeof(CullingPushConstants) == 120);
+
+size_t getLateCommandsOffset(uint32_t numShapes) {
+  return kCommandsOffset + sizeof(DrawIndexedIndirectCommand) * numShapes;
+}
+
+size_t getFlagsOffset(uint32_t numShapes) {
+  return kCommandsOffset + 2 * sizeof(DrawIndexedIndirectCommand) * numShapes;
+}
+
+uint32_t getNextLevelSize(uint32_t size) {
+  return std::max((size + 1) / 2, 1u);
+}
+
+} // namespace
+
+namespace lvk {
+
+DepthPyramid::DepthPyramid(lvk::IContext& ctx, uint32_t width, uint32_t height) :
+  ctx_(ctx), width_(getNextLevelSize(width)), height_(getNextLevelSize(height)) {
+  LVK_ASSERT(width && height);
+
+  comp_ = ctx_.createShaderModule({codeDepthPyramidCS, Stage_Comp, "Shader Module: depth pyramid (comp)"});
+  pipeline_ = ctx_.createComputePipeline({.smComp = comp_, .debugName = "Pipeline: depth pyramid"});
+
+  std::vector<uint32_t> indices;
+
+  for (uint32_t w = width_, h = height_;; w = getNextLevelSize(w), h = getNextLevelSize(h)) {
+    levels_.emplace_back(ctx_.createTexture({
+        .type = TextureType_2D,
+        .format = Format_R_F32,
+        .dimensions = {w, h},
+        .usage = TextureUsageBits_Storage,
+        .debugName = "Texture: depth pyramid level",
+    }));
+    indices.push_back(levels_.back().index());
+    if (w == 1 && h == 1) {
+      break;
+    }
+  }
+
+  levelsBuffer_ = ctx_.createBuffer({.usage = BufferUsageBits_Storage,
+                                     .storage = StorageType_Device,
+                                     .size = sizeof(uint32_t) * indices.size(),
+                                     .data = indices.data(),
+                                     .debugName = "Buffer: depth pyramid levels"});
+}
+
+void DepthPyramid::build(lvk::ICommandBuffer& buffer, lvk::TextureHandle depth) {
+  LVK_PROFILER_FUNCTION();
+
+  buffer.transitionToShaderReadOnly(depth);
+  buffer.cmdBindComputePipeline(pipeline_);
+
+  uint32_t w = width_;
+  uint32_t h = height_;
+
+  for (uint32_t i = 0; i != levels_.size(); i++) {
+    const DepthPyramidPushConstants pc = {
+        .src = i ? levels_[i - 1].index() : depth.index(),
+        .dst = levels_[i].index(),
+        .srcIsDepth = i ? 0u : 1u,
+    };
+    // every level waits for the previous one
+    const Dependencies deps = i ? Dependencies{.textures = {levels_[i - 1], levels_[i]}} : Dependencies{.textures = {levels_[i]}};
+    buffer.cmdPushConstants(pc);
+    buffer.cmdDispatchThreadGroups(
+        {
+            .width = (w + kPyramidLocalSize - 1) / kPyramidLocalSize,
+            .height = (h + kPyramidLocalSize - 1) / kPyramidLocalSize,
+        },
+        deps);
+    w = getNextLevelSize(w);
+    h = getNextLevelSize(h);
+  }
+
+  isBuilt_ = true;
+}
+
+GPUCuller::GPUCuller(lvk::IContext& ctx, const CullingShape* shapes, uint32_t numShapes, uint32_t numViews) :
+  ctx_(ctx), numShapes_(numShapes) {
+  LVK_ASSERT(shapes);
+  LVK_ASSERT(numShapes);
+  LVK_ASSERT(numViews);
+
+  comp_ = ctx_.createShaderModule({codeCullingCS, Stage_Comp, "Shader Module: culling (comp)"});
+  pipeline_ = ctx_.createComputePipeline({.smComp = comp_, .debugName = "Pipeline: culling"});
+  shapes_ = ctx_.createBuffer({.usage = BufferUsageBits_Storage,
+                               .storage = StorageType_Device,
+                               .size = sizeof(CullingShape) * numShapes,
+                               .data = shapes,
+                               .debugName = "Buffer: culling shapes"});
+
+  views_.reserve(numViews);
+
+  for (uint32_t i = 0; i != numViews; i++) {
+    views_.emplace_back(ctx_.createBuffer({.usage = BufferUsageBits_Storage | BufferUsageBits_Indirect,
+                                           .storage = StorageType_Device,
+                                           .size = getFlagsOffset(numShapes) + sizeof(uint32_t) * numShapes,
+                                           .debugName = "Buffer: culling draw commands"}));
+  }
+}
+
+void GPUCuller::dispatch(lvk::ICommandBuffer& buffer, const float mvp[16], uint32_t view, const DepthPyramid* pyramid, uint32_t phase) {
+  const BufferHandle viewBuffer = views_[view];
+
+  CullingPushConstants pc = {
+      .shapes = ctx_.gpuAddress(shapes_),
+      .view = ctx_.gpuAddress(viewBuffer),
+      .flags = ctx_.gpuAddress(viewBuffer, getFlagsOffset(numShapes_)),
+      .numShapes = numShapes_,
+      .phase = phase,
+  };
+  memcpy(pc.mvp, mvp, sizeof(pc.mvp));
+
+  Dependencies deps = {.buffers = {viewBuffer}};
+
+  if (pyramid && pyramid->isBuilt()) {
+    pc.pyramid = ctx_.gpuAddress(pyramid->getLevelsBuffer());
+    pc.pyramidNumLevels = pyramid->getNumLevels();
+    pc.pyramidSize[0] = pyramid->getWidth();
+    pc.pyramidSize[1] = pyramid->getHeight();
+    // all other levels were already waited on while the pyramid was being built
+    deps.textures[0] = pyramid->getLevel(pyramid->getNumLevels() - 1);
+  }
+
+  buffer.cmdBindComputePipeline(pipeline_);
+  buffer.cmdPushConstants(pc);
+  buffer.cmdDispatchThreadGroups({.width = (numShapes_ + kCullingLocalSize - 1) / kCullingLocalSize}, deps);
+}
+
+void GPUCuller::cull(lvk::ICommandBuffer& buffer, const float mvp[16], uint32_t view, const DepthPyramid* pyramid) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT(view < views_.size());
+
+  // reset both the early and the late draw counts
+  buffer.cmdFillBuffer(views_[view], 0, 2 * sizeof(uint32_t), 0);
+
+  dispatch(buffer, mvp, view, pyramid, 0);
+}
+
+void GPUCuller::cullLate(lvk::ICommandBuffer& buffer, const float mvp[16], const DepthPyramid& pyramid, uint32_t view) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT(view < views_.size());
+  LVK_ASSERT(pyramid.isBuilt());
+
+  dispatch(buffer, mvp, view, &pyramid, 1);
+}
+
+lvk::Dependencies GPUCuller::getDependencies(uint32_t view) const {
+  LVK_ASSERT(view < views_.size());
+
+  return {.buffers = {views_[view]}};
+}
+
+void GPUCuller::draw(lvk::ICommandBuffer& buffer, uint32_t view) const {
+  LVK_ASSERT(view < views_.size());
+
+  buffer.cmdDrawIndexedIndirectCount(views_[view], kCommandsOffset, views_[view], 0, numShapes_, sizeof(DrawIndexedIndirectCommand));
+}
+
+void GPUCuller::drawLate(lvk::ICommandBuffer& buffer, uint32_t view) const {
+  LVK_ASSERT(view < views_.size());
+
+  buffer.cmdDrawIndexedIndirectCount(
+      views_[view], getLateCommandsOffset(numShapes_), views_[view], sizeof(uint32_t), numShapes_, sizeof(DrawIndexedIndirectCommand));
+}
+
+} // namespace lvk
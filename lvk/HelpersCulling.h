@@ -0,0 +1,106 @@
+/*
+* LightweightVK
+*
+* This source code is licensed under the MIT license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#pragma once
+
+#include <lvk/LVK.h>
+
+#include <vector>
+
+namespace lvk {
+
+// a bounding sphere in object space and the index range drawn when it is visible
+struct CullingShape {
+  float center[3] = {};
+  float radius = 0.0f;
+  uint32_t firstIndex = 0;
+  uint32_t indexCount = 0;
+  int32_t vertexOffset = 0;
+  uint32_t padding = 0;
+};
+
+// Hierarchical Z buffer: a chain of R32F storage textures where every texel keeps the farthest depth of
+// all the depth buffer pixels it covers. Level 0 is half the size of the depth buffer.
+class DepthPyramid {
+ public:
+  DepthPyramid(lvk::IContext& ctx, uint32_t width, uint32_t height);
+
+  // `depth` is a single-sampled depth texture with TextureUsageBits_Sampled; record outside of rendering
+  void build(lvk::ICommandBuffer& buffer, lvk::TextureHandle depth);
+
+  // false until build() has been recorded at least once
+  bool isBuilt() const {
+    return isBuilt_;
+  }
+  uint32_t getNumLevels() const {
+    return (uint32_t)levels_.size();
+  }
+  lvk::TextureHandle getLevel(uint32_t level) const {
+    return levels_[level];
+  }
+  uint32_t getWidth() const {
+    return width_;
+  }
+  uint32_t getHeight() const {
+    return height_;
+  }
+  // bindless indices of all levels
+  lvk::BufferHandle getLevelsBuffer() const {
+    return levelsBuffer_;
+  }
+
+ private:
+  lvk::IContext& ctx_;
+  lvk::Holder<lvk::ShaderModuleHandle> comp_;
+  lvk::Holder<lvk::ComputePipelineHandle> pipeline_;
+  std::vector<lvk::Holder<lvk::TextureHandle>> levels_;
+  lvk::Holder<lvk::BufferHandle> levelsBuffer_;
+  uint32_t width_ = 0;
+  uint32_t height_ = 0;
+  bool isBuilt_ = false;
+};
+
+// GPU culling: a compute pass writes one VkDrawIndexedIndirectCommand per visible shape, then everything
+// visible is drawn with a single cmdDrawIndexedIndirectCount(). Each view (main camera, shadow light, etc.)
+// has its own output buffer so several views can be culled in one frame.
+//
+// Two-phase occlusion culling:
+//   1. cull() with the depth pyramid of the previous frame, then draw()
+//   2. DepthPyramid::build() from the depth of step 1
+//   3. cullLate() re-tests the shapes which step 1 rejected against the new pyramid, then drawLate()
+// Everything rejected in step 1 gets a second chance in step 3, so a stale pyramid never drops geometry.
+class GPUCuller {
+ public:
+  GPUCuller(lvk::IContext& ctx, const CullingShape* shapes, uint32_t numShapes, uint32_t numViews = 1);
+
+  // `mvp` is a column-major object-to-clip matrix; record outside of rendering
+  void cull(lvk::ICommandBuffer& buffer, const float mvp[16], uint32_t view = 0, const DepthPyramid* pyramid = nullptr);
+  void cullLate(lvk::ICommandBuffer& buffer, const float mvp[16], const DepthPyramid& pyramid, uint32_t view = 0);
+  // pass to cmdBeginRendering() so the indirect draw waits for the culling results
+  lvk::Dependencies getDependencies(uint32_t view = 0) const;
+  // draw visible shapes using the currently bound pipeline, vertex and index buffers
+  void draw(lvk::ICommandBuffer& buffer, uint32_t view = 0) const;
+  void drawLate(lvk::ICommandBuffer& buffer, uint32_t view = 0) const;
+
+  uint32_t getNumShapes() const {
+    return numShapes_;
+  }
+
+ private:
+  void dispatch(lvk::ICommandBuffer& buffer, const float mvp[16], uint32_t view, const DepthPyramid* pyramid, uint32_t phase);
+
+ private:
+  lvk::IContext& ctx_;
+  lvk::Holder<lvk::ShaderModuleHandle> comp_;
+  lvk::Holder<lvk::ComputePipelineHandle> pipeline_;
+  lvk::Holder<lvk::BufferHandle> shapes_;
+  // draw counts, early and late indirect commands, per-shape "drawn early" flags
+  std::vector<lvk::Holder<lvk::BufferHandle>> views_;
+  uint32_t numShapes_ = 0;
+};
+
+} // namespace lvk
@@ -0,0 +1,210 @@
+/*
+* LightweightVK
+*
+* This source code is licensed under the MIT license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include "HelpersDrawList.h"
+
+#include <string.h>
+#include <utility>
+
+uint64_t lvk::DrawList::makeSortKey(uint32_t pass, uint32_t pipeline, uint32_t material, float depth, bool backToFront) {
+  const uint64_t kDepthMask = (1ull << 24) - 1;
+
+  // non-negative floats are ordered like their bit patterns; keep the exponent and the top 16 bits of the mantissa
+  const float d = depth > 0.0f ? depth : 0.0f; // also catches NaNs
+  uint32_t bits = 0;
+  memcpy(&bits, &d, sizeof(bits));
+
+  uint64_t depthBits = (bits >> 7) & kDepthMask;
+
+  if (backToFront) {
+    depthBits = kDepthMask - depthBits;
+  }
+
+  return (uint64_t(pass & 0xff) << 56) | (uint64_t(pipeline & 0xfff) << 44) | (uint64_t(material & 0xfffff) << 24) | depthBits;
+}
+
+void lvk::DrawList::add(const DrawListItem& item, const void* pushConstants, uint32_t pushConstantsSize) {
+  LVK_ASSERT(pushConstants || !pushConstantsSize);
+
+  pushConstantsRanges_.push_back({(uint32_t)pushConstants_.size(), pushConstantsSize});
+
+  if (pushConstantsSize) {
+    const uint8_t* data = static_cast<const uint8_t*>(pushConstants);
+    pushConstants_.insert(pushConstants_.end(), data, data + pushConstantsSize);
+  }
+
+  items_.push_back(item);
+
+  isSorted_ = false;
+}
+
+void lvk::DrawList::sort() {
+  LVK_PROFILER_FUNCTION();
+
+  isSorted_ = true;
+
+  const uint32_t n = size();
+
+  order_.resize(n);
+  scratch_.resize(n);
+
+  if (!n) {
+    return;
+  }
+
+  for (uint32_t i = 0; i != n; i++) {
+    order_[i] = {items_[i].sortKey, i};
+  }
+
+  // LSD radix sort with 8-bit digits; the histograms of all digits are built in one pass over the keys
+  uint32_t histograms[8][256] = {};
+
+  for (const SortEntry& e : order_) {
+    for (uint32_t d = 0; d != 8; d++) {
+      histograms[d][(e.key >> (d * 8)) & 0xff]++;
+    }
+  }
+
+  SortEntry* src = order_.data();
+  SortEntry* dst = scratch_.data();
+
+  for (uint32_t d = 0; d != 8; d++) {
+    uint32_t* h = histograms[d];
+    const uint32_t shift = d * 8;
+
+    // all keys have the same digit here, the pass would not change anything
+    if (h[(src[0].key >> shift) & 0xff] == n) {
+      continue;
+    }
+
+    uint32_t sum = 0;
+    for (uint32_t b = 0; b != 256; b++) {
+      const uint32_t count = h[b];
+      h[b] = sum;
+      sum += count;
+    }
+
+    for (uint32_t i = 0; i != n; i++) {
+      dst[h[(src[i].key >> shift) & 0xff]++] = src[i];
+    }
+
+    std::swap(src, dst);
+  }
+
+  if (src != order_.data()) {
+    order_.swap(scratch_);
+  }
+}
+
+bool lvk::DrawList::hasSamePushConstants(const PushConstantsRange& a, const PushConstantsRange& b) const {
+  return a.size == b.size && !memcmp(pushConstants_.data() + a.offset, pushConstants_.data() + b.offset, a.size);
+}
+
+void lvk::DrawList::flushMultiDraw(lvk::ICommandBuffer& buffer) {
+  if (multiDraws_.empty()) {
+    return;
+  }
+
+  if (multiDraws_.size() == 1) {
+    const DrawIndexedInfo& d = multiDraws_[0];
+    buffer.cmdDrawIndexed(d.indexCount, multiDrawInstanceCount_, d.firstIndex, d.vertexOffset, multiDrawBaseInstance_);
+  } else {
+    buffer.cmdDrawIndexedMulti(multiDraws_.data(), (uint32_t)multiDraws_.size(), multiDrawInstanceCount_, multiDrawBaseInstance_);
+  }
+
+  stats_.drawCalls++;
+
+  multiDraws_.clear();
+}
+
+void lvk::DrawList::execute(lvk::ICommandBuffer& buffer) {
+  LVK_PROFILER_FUNCTION();
+
+  if (!isSorted_) {
+    sort();
+  }
+
+  stats_ = {};
+
+  // what is currently bound
+  RenderPipelineHandle pipeline;
+  BufferHandle vertexBuffer;
+  uint64_t vertexBufferOffset = 0;
+  BufferHandle indexBuffer;
+  IndexFormat indexFormat = IndexFormat_UI32;
+  uint64_t indexBufferOffset = 0;
+  PushConstantsRange pushConstants;
+  bool hasPushConstants = false;
+
+  for (const SortEntry& e : order_) {
+    const DrawListItem& d = items_[e.index];
+    const PushConstantsRange& push = pushConstantsRanges_[e.index];
+
+    const bool newPipeline = d.pipeline != pipeline;
+    const bool newVertexBuffer = d.vertexBuffer && (d.vertexBuffer != vertexBuffer || d.vertexBufferOffset != vertexBufferOffset);
+    const bool newIndexBuffer =
+        d.indexBuffer && (d.indexBuffer != indexBuffer || d.indexFormat != indexFormat || d.indexBufferOffset != indexBufferOffset);
+    // push constants are not guaranteed to survive a pipeline change, so they are pushed again after every bind
+    const bool newPushConstants = push.size && (newPipeline || !hasPushConstants || !hasSamePushConstants(push, pushConstants));
+
+    if (newPipeline || newVertexBuffer || newIndexBuffer || newPushConstants) {
+      flushMultiDraw(buffer);
+    }
+
+    if (newPipeline) {
+      buffer.cmdBindRenderPipeline(d.pipeline);
+      pipeline = d.pipeline;
+      hasPushConstants = false;
+      stats_.pipelineBinds++;
+    }
+    if (newVertexBuffer) {
+      buffer.cmdBindVertexBuffer(0, d.vertexBuffer, d.vertexBufferOffset);
+      vertexBuffer = d.vertexBuffer;
+      vertexBufferOffset = d.vertexBufferOffset;
+      stats_.vertexBufferBinds++;
+    }
+    if (newIndexBuffer) {
+      buffer.cmdBindIndexBuffer(d.indexBuffer, d.indexFormat, d.indexBufferOffset);
+      indexBuffer = d.indexBuffer;
+      indexFormat = d.indexFormat;
+      indexBufferOffset = d.indexBufferOffset;
+      stats_.indexBufferBinds++;
+    }
+    if (newPushConstants) {
+      buffer.cmdPushConstants(pushConstants_.data() + push.offset, push.size);
+      pushConstants = push;
+      hasPushConstants = true;
+      stats_.pushConstants++;
+    }
+
+    if (!d.indexBuffer) {
+      flushMultiDraw(buffer);
+      buffer.cmdDraw(d.count, d.instanceCount, d.first, d.baseInstance);
+      stats_.drawCalls++;
+      continue;
+    }
+
+    if (!multiDraws_.empty() && (d.instanceCount != multiDrawInstanceCount_ || d.baseInstance != multiDrawBaseInstance_)) {
+      flushMultiDraw(buffer);
+    }
+
+    multiDraws_.push_back({.firstIndex = d.first, .indexCount = d.count, .vertexOffset = d.vertexOffset});
+    multiDrawInstanceCount_ = d.instanceCount;
+    multiDrawBaseInstance_ = d.baseInstance;
+  }
+
+  flushMultiDraw(buffer);
+}
+
+void lvk::DrawList::clear() {
+  items_.clear();
+  pushConstantsRanges_.clear();
+  pushConstants_.clear();
+  order_.clear();
+  multiDraws_.clear();
+  isSorted_ = true;
+}
@@ -0,0 +1,92 @@
+/*
+* LightweightVK
+*
+* This source code is licensed under the MIT license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#pragma once
+
+#include <lvk/LVK.h>
+
+#include <vector>
+
+namespace lvk {
+
+// one deferred draw; an empty `indexBuffer` means a non-indexed draw of `count` vertices
+struct DrawListItem {
+  uint64_t sortKey = 0;
+  RenderPipelineHandle pipeline;
+  BufferHandle vertexBuffer;
+  uint64_t vertexBufferOffset = 0;
+  BufferHandle indexBuffer;
+  IndexFormat indexFormat = IndexFormat_UI32;
+  uint64_t indexBufferOffset = 0;
+  uint32_t count = 0; // indices or vertices
+  uint32_t instanceCount = 1;
+  uint32_t first = 0; // first index or vertex
+  int32_t vertexOffset = 0;
+  uint32_t baseInstance = 0;
+};
+
+// Draws which are added in scene traversal order and replayed sorted by their 64-bit keys:
+//   1. add() every draw with a key from makeSortKey()
+//   2. execute() inside cmdBeginRendering() sorts the draws and binds pipelines, vertex and index buffers and push constants only
+//      when they change; runs of indexed draws which share all state are merged into one cmdDrawIndexedMulti()
+//   3. clear() before the next frame
+class DrawList final {
+ public:
+  struct Stats {
+    uint32_t pipelineBinds = 0;
+    uint32_t vertexBufferBinds = 0;
+    uint32_t indexBufferBinds = 0;
+    uint32_t pushConstants = 0;
+    uint32_t drawCalls = 0; // a merged cmdDrawIndexedMulti() counts as one
+  };
+
+  // From the most significant bits: pass (8 bits), pipeline (12), material (20), depth (24). Values wider than their fields are
+  // truncated. `depth` is a non-negative view-space distance; near draws go first unless `backToFront` is set (for blending).
+  static uint64_t makeSortKey(uint32_t pass, uint32_t pipeline, uint32_t material, float depth, bool backToFront = false);
+
+  void add(const DrawListItem& item, const void* pushConstants = nullptr, uint32_t pushConstantsSize = 0);
+  void sort();
+  void execute(lvk::ICommandBuffer& buffer);
+  void clear();
+
+  uint32_t size() const {
+    return (uint32_t)items_.size();
+  }
+  // state changes recorded by the last execute()
+  const Stats& getStats() const {
+    return stats_;
+  }
+
+ private:
+  struct PushConstantsRange {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+  };
+  struct SortEntry {
+    uint64_t key = 0;
+    uint32_t index = 0;
+  };
+
+  bool hasSamePushConstants(const PushConstantsRange& a, const PushConstantsRange& b) const;
+  void flushMultiDraw(lvk::ICommandBuffer& buffer);
+
+ private:
+  std::vector<DrawListItem> items_;
+  std::vector<PushConstantsRange> pushConstantsRanges_; // one per item
+  std::vector<uint8_t> pushConstants_;
+  // sorted order of `items_` and the ping-pong buffer of the radix sort
+  std::vector<SortEntry> order_;
+  std::vector<SortEntry> scratch_;
+  // pending indexed draws which share all state
+  std::vector<DrawIndexedInfo> multiDraws_;
+  uint32_t multiDrawInstanceCount_ = 1;
+  uint32_t multiDrawBaseInstance_ = 0;
+  Stats stats_;
+  bool isSorted_ = true;
+};
+
+} // namespace lvk
@@ -206,6 +206,7 @@ void ImGuiRenderer::endFrame(lvk::ICommandBuffer& cmdBuffer) {
         .storage = lvk::StorageType_HostVisible,
         .size = dd->TotalIdxCount * sizeof(ImDrawIdx),
         .debugName = "ImGui: drawableData.ib_",
+        .suballocate = true,
     });
     drawableData.numAllocatedIndices_ = dd->TotalIdxCount;
   }
@@ -215,6 +216,7 @@ void ImGuiRenderer::endFrame(lvk::ICommandBuffer& cmdBuffer) {
         .storage = lvk::StorageType_HostVisible,
         .size = dd->TotalVtxCount * sizeof(ImDrawVert),
         .debugName = "ImGui: drawableData.vb_",
+        .suballocate = true,
     });
     drawableData.numAllocatedVerteices_ = dd->TotalVtxCount;
   }
@@ -0,0 +1,380 @@
+/*
+* LightweightVK
+*
+* This source code is licensed under the MIT license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#include "HelpersRenderGraph.h"
+
+#include <algorithm>
+
+namespace {
+
+// one class per image layout, chosen the same way as ICommandBuffer::cmdPipelineBarrier() does; different classes need a transition
+enum LayoutClass : uint8_t {
+  LayoutClass_Unknown = 0,
+  LayoutClass_General, // storage images, also when they are only read
+  LayoutClass_ShaderReadOnly,
+  LayoutClass_ColorAttachment,
+  LayoutClass_DepthAttachment,
+  LayoutClass_DepthAttachmentRead,
+  LayoutClass_TransferRead,
+  LayoutClass_TransferWrite,
+};
+
+LayoutClass getLayoutClass(uint32_t access, bool isSampled) {
+  if (access & (lvk::ResourceAccessBits_GraphicsShaderWrite | lvk::ResourceAccessBits_ComputeShaderWrite))
+    return LayoutClass_General;
+  if (access & (lvk::ResourceAccessBits_GraphicsShaderRead | lvk::ResourceAccessBits_ComputeShaderRead))
+    return isSampled ? LayoutClass_ShaderReadOnly : LayoutClass_General;
+  if (access & lvk::ResourceAccessBits_ColorAttachment)
+    return LayoutClass_ColorAttachment;
+  if (access & lvk::ResourceAccessBits_DepthAttachment)
+    return LayoutClass_DepthAttachment;
+  if (access & lvk::ResourceAccessBits_DepthAttachmentRead)
+    return LayoutClass_DepthAttachmentRead;
+  if (access & lvk::ResourceAccessBits_TransferRead)
+    return LayoutClass_TransferRead;
+  if (access & lvk::ResourceAccessBits_TransferWrite)
+    return LayoutClass_TransferWrite;
+  return LayoutClass_Unknown;
+}
+
+bool isSameAliasedTexture(const lvk::AliasedTextureDesc& a, const lvk::AliasedTextureDesc& b) {
+  return a.desc.type == b.desc.type && a.desc.format == b.desc.format && a.desc.dimensions.width == b.desc.dimensions.width &&
+         a.desc.dimensions.height == b.desc.dimensions.height && a.desc.dimensions.depth == b.desc.dimensions.depth &&
+         a.desc.numLayers == b.desc.numLayers && a.desc.numSamples == b.desc.numSamples && a.desc.usage == b.desc.usage &&
+         a.desc.numMipLevels == b.desc.numMipLevels && a.desc.storage == b.desc.storage && a.firstUse == b.firstUse &&
+         a.lastUse == b.lastUse;
+}
+
+} // namespace
+
+namespace lvk {
+
+RenderGraph::Resource RenderGraph::importTexture(lvk::TextureHandle texture, uint32_t lastAccess) {
+  LVK_ASSERT(!texture.empty());
+
+  resources_.push_back({.texture = texture, .lastAccess = lastAccess});
+
+  return Resource(resources_.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::importBuffer(lvk::BufferHandle buffer, uint32_t lastAccess) {
+  LVK_ASSERT(!buffer.empty());
+
+  resources_.push_back({.buffer = buffer, .lastAccess = lastAccess});
+
+  return Resource(resources_.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::createTexture(const lvk::TextureDesc& desc) {
+  LVK_ASSERT_MSG(!desc.data, "Transient textures cannot be initialized with data");
+
+  resources_.push_back({.desc = desc, .isTransient = true});
+
+  return Resource(resources_.size() - 1);
+}
+
+uint32_t RenderGraph::addPass(const char* name, ExecuteFn&& execute, bool hasSideEffects) {
+  LVK_ASSERT(!isCompiled_);
+
+  passes_.push_back({.name = name, .execute = std::move(execute), .hasSideEffects = hasSideEffects});
+
+  return uint32_t(passes_.size() - 1);
+}
+
+void RenderGraph::read(uint32_t pass, Resource resource, uint32_t access) {
+  LVK_ASSERT(!isCompiled_);
+  LVK_ASSERT(pass < passes_.size());
+  LVK_ASSERT(resource < resources_.size());
+  LVK_ASSERT_MSG((access & kResourceAccessWriteBits) == 0, "Use RenderGraph::write() for write accesses");
+
+  passes_[pass].accesses.push_back({resource, access});
+}
+
+void RenderGraph::write(uint32_t pass, Resource resource, uint32_t access) {
+  LVK_ASSERT(!isCompiled_);
+  LVK_ASSERT(pass < passes_.size());
+  LVK_ASSERT(resource < resources_.size());
+  LVK_ASSERT_MSG((access & kResourceAccessWriteBits) != 0, "Use RenderGraph::read() for read accesses");
+
+  passes_[pass].accesses.push_back({resource, access});
+}
+
+void RenderGraph::cullPasses() {
+  // everything imported outlives the graph; everything else is needed only if a surviving pass accesses it
+  std::vector<bool> isNeeded(resources_.size(), false);
+
+  for (size_t i = 0; i != resources_.size(); i++) {
+    isNeeded[i] = !resources_[i].isTransient;
+  }
+
+  for (size_t p = passes_.size(); p-- > 0;) {
+    PassNode& pass = passes_[p];
+    bool isAlive = pass.hasSideEffects;
+    for (const Access& a : pass.accesses) {
+      if ((a.access & kResourceAccessWriteBits) && isNeeded[a.resource]) {
+        isAlive = true;
+      }
+    }
+    pass.isCulled = !isAlive;
+    if (!isAlive) {
+      continue;
+    }
+    // writes keep the previous writers alive as well: a pass can load what was there before (LoadOp_Load, blending, etc.)
+    for (const Access& a : pass.accesses) {
+      isNeeded[a.resource] = true;
+    }
+  }
+}
+
+void RenderGraph::createTransientTextures() {
+  for (uint32_t p = 0; p != passes_.size(); p++) {
+    if (passes_[p].isCulled) {
+      continue;
+    }
+    for (const Access& a : passes_[p].accesses) {
+      ResourceNode& r = resources_[a.resource];
+      if (r.isTransient) {
+        r.firstPass = std::min(r.firstPass, p);
+        r.lastPass = std::max(r.lastPass, p);
+      }
+    }
+  }
+
+  std::vector<AliasedTextureDesc> descs;
+  std::vector<Resource> owners;
+
+  for (Resource i = 0; i != resources_.size(); i++) {
+    const ResourceNode& r = resources_[i];
+    if (r.isTransient && r.firstPass <= r.lastPass) {
+      descs.push_back({.desc = r.desc, .firstUse = r.firstPass, .lastUse = r.lastPass});
+      owners.push_back(i);
+    }
+  }
+
+  bool isSame = descs.size() == transientDescs_.size();
+
+  for (size_t i = 0; isSame && i != descs.size(); i++) {
+    isSame = isSameAliasedTexture(descs[i], transientDescs_[i]);
+  }
+
+  if (!isSame) {
+    // the old textures are released through the deferred destruction queue
+    transientTextures_.clear();
+    transientTextures_.resize(descs.size());
+    transientDescs_ = descs;
+    if (!descs.empty()) {
+      const Result result =
+          ctx_.createAliasedTextures(descs.data(), (uint32_t)descs.size(), transientTextures_.data(), "RenderGraph: transient");
+      if (!LVK_VERIFY(result.isOk())) {
+        transientTextures_.clear();
+        transientDescs_.clear();
+        return;
+      }
+    }
+  }
+
+  for (size_t i = 0; i != owners.size(); i++) {
+    resources_[owners[i]].texture = transientTextures_[i];
+  }
+}
+
+void RenderGraph::computeBarriers() {
+  struct State {
+    uint32_t lastWrite = ResourceAccessBits_None;
+    uint32_t reads = ResourceAccessBits_None; // all reads since the last write
+    uint32_t visibleTo = ResourceAccessBits_None; // reads which already waited for the last write
+    LayoutClass layout = LayoutClass_Unknown;
+    bool isInitialized = false;
+    bool isSampled = false;
+  };
+
+  std::vector<State> states(resources_.size());
+
+  // aliased memory and the previous frame: the first access to a transient texture waits for all transient accesses
+  uint32_t transientAccessMask = ResourceAccessBits_None;
+
+  for (Resource i = 0; i != resources_.size(); i++) {
+    const ResourceNode& r = resources_[i];
+    State& st = states[i];
+    st.lastWrite = r.lastAccess & kResourceAccessWriteBits;
+    st.reads = r.lastAccess & ~kResourceAccessWriteBits;
+    st.isSampled = r.texture.valid() && (ctx_.getTextureUsage(r.texture) & TextureUsageBits_Sampled);
+    st.layout = getLayoutClass(r.lastAccess, st.isSampled);
+    st.isInitialized = !r.isTransient;
+  }
+
+  for (const PassNode& pass : passes_) {
+    if (pass.isCulled) {
+      continue;
+    }
+    for (const Access& a : pass.accesses) {
+      if (resources_[a.resource].isTransient) {
+        transientAccessMask |= a.access;
+      }
+    }
+  }
+
+  // merged accesses of one pass; a pass rarely touches more than a handful of resources
+  std::vector<Access> merged;
+
+  for (PassNode& pass : passes_) {
+    pass.firstBufferBarrier = (uint32_t)bufferBarriers_.size();
+    pass.firstTextureBarrier = (uint32_t)textureBarriers_.size();
+
+    if (pass.isCulled) {
+      continue;
+    }
+
+    merged.clear();
+
+    for (const Access& a : pass.accesses) {
+      auto it = std::find_if(merged.begin(), merged.end(), [&a](const Access& m) { return m.resource == a.resource; });
+      if (it == merged.end()) {
+        merged.push_back(a);
+      } else {
+        it->access |= a.access;
+      }
+    }
+
+    for (const Access& a : merged) {
+      const ResourceNode& r = resources_[a.resource];
+      State& st = states[a.resource];
+
+      if (!r.texture.valid() && !r.buffer.valid()) {
+        // transient texture creation failed
+        continue;
+      }
+
+      const bool isTexture = r.texture.valid();
+      const bool isWrite = (a.access & kResourceAccessWriteBits) != 0;
+      const LayoutClass layout = isTexture ? getLayoutClass(a.access, st.isSampled) : LayoutClass_Unknown;
+      const bool isLayoutChanged = isTexture && layout != LayoutClass_Unknown && layout != st.layout;
+
+      bool needsBarrier = false;
+      bool discard = false;
+      uint32_t before = ResourceAccessBits_None;
+
+      if (!st.isInitialized) {
+        needsBarrier = true;
+        discard = true;
+        before = transientAccessMask;
+        st.isInitialized = true;
+      } else if (isWrite) {
+        // write-after-write and write-after-read
+        before = st.lastWrite | st.reads;
+        needsBarrier = before != ResourceAccessBits_None || isLayoutChanged;
+      } else if (isLayoutChanged) {
+        // a layout transition is a write as well
+        before = st.lastWrite | st.reads;
+        needsBarrier = true;
+      } else if (st.lastWrite && (a.access & ~st.visibleTo)) {
+        // read-after-write; read-after-read needs no barrier
+        before = st.lastWrite;
+        needsBarrier = true;
+      }
+
+      if (needsBarrier) {
+        if (isTexture) {
+          textureBarriers_.push_back({.texture = r.texture, .before = before, .after = a.access, .discard = discard});
+          if (layout != LayoutClass_Unknown) {
+            st.layout = layout;
+          }
+        } else {
+          bufferBarriers_.push_back({.buffer = r.buffer, .before = before, .after = a.access});
+        }
+      }
+
+      if (isWrite) {
+        st.lastWrite = a.access;
+        st.reads = ResourceAccessBits_None;
+        st.visibleTo = ResourceAccessBits_None;
+      } else {
+        st.reads |= a.access;
+        if (needsBarrier && isLayoutChanged) {
+          // other readers have to wait for the layout transition
+          st.lastWrite = a.access;
+          st.visibleTo = a.access;
+        } else if (needsBarrier) {
+          st.visibleTo |= a.access;
+        }
+      }
+    }
+
+    pass.numBufferBarriers = (uint32_t)bufferBarriers_.size() - pass.firstBufferBarrier;
+    pass.numTextureBarriers = (uint32_t)textureBarriers_.size() - pass.firstTextureBarrier;
+  }
+}
+
+void RenderGraph::compile() {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT(!isCompiled_);
+
+  cullPasses();
+  createTransientTextures();
+  computeBarriers();
+
+  isCompiled_ = true;
+}
+
+void RenderGraph::execute(lvk::ICommandBuffer& buffer) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT_MSG(isCompiled_, "Call RenderGraph::compile() first");
+
+  buffer.setAutomaticBarriers(false);
+
+  for (const PassNode& pass : passes_) {
+    if (pass.isCulled) {
+      continue;
+    }
+    if (pass.numBufferBarriers || pass.numTextureBarriers) {
+      buffer.cmdPipelineBarrier(bufferBarriers_.data() + pass.firstBufferBarrier,
+                                pass.numBufferBarriers,
+                                textureBarriers_.data() + pass.firstTextureBarrier,
+                                pass.numTextureBarriers);
+    }
+    buffer.cmdPushDebugGroupLabel(pass.name, 0xff00ffff);
+    if (pass.execute) {
+      pass.execute(buffer);
+    }
+    buffer.cmdPopDebugGroupLabel();
+  }
+
+  buffer.setAutomaticBarriers(true);
+}
+
+void RenderGraph::reset() {
+  resources_.clear();
+  passes_.clear();
+  bufferBarriers_.clear();
+  textureBarriers_.clear();
+  isCompiled_ = false;
+}
+
+lvk::TextureHandle RenderGraph::getTexture(Resource resource) const {
+  LVK_ASSERT(isCompiled_);
+  LVK_ASSERT(resource < resources_.size());
+
+  return resources_[resource].texture;
+}
+
+lvk::BufferHandle RenderGraph::getBuffer(Resource resource) const {
+  LVK_ASSERT(isCompiled_);
+  LVK_ASSERT(resource < resources_.size());
+
+  return resources_[resource].buffer;
+}
+
+bool RenderGraph::isCulled(uint32_t pass) const {
+  LVK_ASSERT(isCompiled_);
+  LVK_ASSERT(pass < passes_.size());
+
+  return passes_[pass].isCulled;
+}
+
+} // namespace lvk
@@ -0,0 +1,105 @@
+/*
+* LightweightVK
+*
+* This source code is licensed under the MIT license found in the
+* LICENSE file in the root directory of this source tree.
+*/
+
+#pragma once
+
+#include <lvk/LVK.h>
+
+#include <functional>
+#include <vector>
+
+namespace lvk {
+
+// Opt-in frame graph on top of ICommandBuffer. Passes declare how they access resources (ResourceAccessBits) and compile():
+//   1. culls passes whose results are never used by imported resources or passes with side effects
+//   2. places transient textures with non-overlapping lifetimes into shared memory
+//   3. computes one batch of barriers per pass: read-after-read needs nothing, layouts change only when required
+// execute() records all passes into one command buffer with the automatic barriers of ICommandBuffer disabled, so every texture and
+// buffer touched by a pass, including render targets and resolve targets, has to be declared.
+//
+// Typical frame:
+//   graph.reset();
+//   const auto color = graph.importTexture(swapchainTexture);
+//   const auto pass = graph.addPass("Main", [&](lvk::ICommandBuffer& buffer) { ... });
+//   graph.write(pass, color, lvk::ResourceAccessBits_ColorAttachment);
+//   graph.compile();
+//   graph.execute(buffer);
+class RenderGraph final {
+ public:
+  using Resource = uint32_t;
+  using ExecuteFn = std::function<void(lvk::ICommandBuffer& buffer)>;
+
+  explicit RenderGraph(lvk::IContext& ctx) : ctx_(ctx) {}
+
+  // `lastAccess` is how the resource was accessed before the graph; the default waits for everything
+  Resource importTexture(lvk::TextureHandle texture, uint32_t lastAccess = ResourceAccessBits_Any);
+  Resource importBuffer(lvk::BufferHandle buffer, uint32_t lastAccess = ResourceAccessBits_Any);
+  // a texture which exists only while the graph is executed; its contents are undefined before the first write
+  Resource createTexture(const lvk::TextureDesc& desc);
+
+  // passes run in the order they were added; passes with side effects (readbacks, etc.) are never culled
+  uint32_t addPass(const char* name, ExecuteFn&& execute, bool hasSideEffects = false);
+  void read(uint32_t pass, Resource resource, uint32_t access);
+  void write(uint32_t pass, Resource resource, uint32_t access);
+
+  void compile();
+  void execute(lvk::ICommandBuffer& buffer);
+  // removes all passes and resources; transient textures are kept for the next frame if their layout did not change
+  void reset();
+
+  // valid after compile()
+  lvk::TextureHandle getTexture(Resource resource) const;
+  lvk::BufferHandle getBuffer(Resource resource) const;
+  bool isCulled(uint32_t pass) const;
+  uint32_t getNumBarriers() const {
+    return uint32_t(bufferBarriers_.size() + textureBarriers_.size());
+  }
+
+ private:
+  struct ResourceNode {
+    lvk::TextureHandle texture;
+    lvk::BufferHandle buffer;
+    lvk::TextureDesc desc; // transient textures only
+    uint32_t lastAccess = ResourceAccessBits_None;
+    bool isTransient = false;
+    // lifetime of a transient texture in pass indices
+    uint32_t firstPass = ~0u;
+    uint32_t lastPass = 0;
+  };
+  struct Access {
+    Resource resource = 0;
+    uint32_t access = ResourceAccessBits_None;
+  };
+  struct PassNode {
+    const char* name = "";
+    ExecuteFn execute;
+    std::vector<Access> accesses;
+    bool hasSideEffects = false;
+    bool isCulled = false;
+    uint32_t firstBufferBarrier = 0;
+    uint32_t numBufferBarriers = 0;
+    uint32_t firstTextureBarrier = 0;
+    uint32_t numTextureBarriers = 0;
+  };
+
+  void cullPasses();
+  void createTransientTextures();
+  void computeBarriers();
+
+ private:
+  lvk::IContext& ctx_;
+  std::vector<ResourceNode> resources_;
+  std::vector<PassNode> passes_;
+  std::vector<BufferBarrier> bufferBarriers_;
+  std::vector<TextureBarrier> textureBarriers_;
+  // transient textures of the previous compile() and the descriptions they were created from
+  std::vector<AliasedTextureDesc> transientDescs_;
+  std::vector<lvk::Holder<lvk::TextureHandle>> transientTextures_;
+  bool isCompiled_ = false;
+};
+
+} // namespace lvk
@@ -99,6 +99,11 @@ bool initVulkanContextWithSwapchain(std::unique_ptr<lvk::VulkanContext>& ctx,
     }
   }
 
+  if (!numDevices) {
+    // any other device, for example, a software ICD (lavapipe, SwiftShader)
+    numDevices = ctx->queryDevices(HWDeviceType_Software, &device);
+  }
+
   if (!numDevices) {
     LVK_ASSERT_MSG(false, "GPU is not found");
     return false;
@@ -258,6 +263,12 @@ void lvk::destroy(lvk::IContext* ctx, lvk::QueryPoolHandle handle) {
   }
 }
 
+void lvk::destroy(lvk::IContext* ctx, lvk::CommandBundleHandle handle) {
+  if (ctx) {
+    ctx->destroy(handle);
+  }
+}
+
 // Logs GLSL shaders with line numbers annotation
 void lvk::logShaderSource(const char* text) {
   uint32_t line = 0;
@@ -413,4 +424,16 @@ std::unique_ptr<lvk::IContext> lvk::createVulkanContextWithSwapchain(ANativeWind
   }
   return std::move(ctx);
 }
-#endif
\ No newline at end of file
+#endif
+
+std::unique_ptr<lvk::IContext> lvk::createVulkanContextHeadless(uint32_t width,
+                                                               uint32_t height,
+                                                               const lvk::ContextConfig& cfg,
+                                                               lvk::HWDeviceType preferredDeviceType) {
+  using namespace lvk;
+  std::unique_ptr<VulkanContext> ctx = std::make_unique<VulkanContext>(cfg, nullptr);
+  if (!initVulkanContextWithSwapchain(ctx, width, height, preferredDeviceType)) {
+    return nullptr;
+  }
+  return std::move(ctx);
+}
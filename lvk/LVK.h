@@ -10,6 +10,8 @@
 #include <cstdarg>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <utility>
 
@@ -93,7 +95,7 @@ class Handle final {
  private:
   Handle(uint32_t index, uint32_t gen) : index_(index), gen_(gen){};
 
-  template<typename ObjectType_, typename ImplObjectType>
+  template<typename ObjectType_, typename ImplObjectType, typename ColdObjectType>
   friend class Pool;
 
   uint32_t index_ = 0;
@@ -110,6 +112,7 @@ using SamplerHandle = lvk::Handle<struct Sampler>;
 using BufferHandle = lvk::Handle<struct Buffer>;
 using TextureHandle = lvk::Handle<struct Texture>;
 using QueryPoolHandle = lvk::Handle<struct QueryPool>;
+using CommandBundleHandle = lvk::Handle<struct CommandBundle>;
 
 // forward declarations to access incomplete type IContext
 void destroy(lvk::IContext* ctx, lvk::ComputePipelineHandle handle);
@@ -119,6 +122,7 @@ void destroy(lvk::IContext* ctx, lvk::SamplerHandle handle);
 void destroy(lvk::IContext* ctx, lvk::BufferHandle handle);
 void destroy(lvk::IContext* ctx, lvk::TextureHandle handle);
 void destroy(lvk::IContext* ctx, lvk::QueryPoolHandle handle);
+void destroy(lvk::IContext* ctx, lvk::CommandBundleHandle handle);
 
 template<typename HandleType>
 class Holder final {
@@ -199,6 +203,7 @@ class Holder final {
 namespace lvk {
 
 enum { LVK_MAX_COLOR_ATTACHMENTS = 8 };
+enum { LVK_MAX_FRAMES_IN_FLIGHT = 4 };
 enum { LVK_MAX_MIP_LEVELS = 16 };
 
 enum IndexFormat : uint8_t {
@@ -220,6 +225,14 @@ enum ColorSpace : uint8_t {
   ColorSpace_SRGB_NONLINEAR,
 };
 
+// unsupported modes fall back to PresentMode_Fifo, which is always available
+enum PresentMode : uint8_t {
+  PresentMode_Auto, // Immediate on Linux, then Mailbox, then Fifo
+  PresentMode_Fifo,
+  PresentMode_Mailbox,
+  PresentMode_Immediate,
+};
+
 enum TextureType : uint8_t {
   TextureType_2D,
   TextureType_3D,
@@ -386,6 +399,19 @@ struct DepthState {
   bool isDepthWriteEnabled = false;
 };
 
+// one draw of cmdDrawMulti(); same memory layout as VkMultiDrawInfoEXT
+struct DrawInfo {
+  uint32_t firstVertex = 0;
+  uint32_t vertexCount = 0;
+};
+
+// one draw of cmdDrawIndexedMulti(); same memory layout as VkMultiDrawIndexedInfoEXT
+struct DrawIndexedInfo {
+  uint32_t firstIndex = 0;
+  uint32_t indexCount = 0;
+  int32_t vertexOffset = 0;
+};
+
 enum PolygonMode : uint8_t {
   PolygonMode_Fill = 0,
   PolygonMode_Line = 1,
@@ -499,6 +525,13 @@ enum StoreOp : uint8_t {
   StoreOp_None,
 };
 
+enum ResolveMode : uint8_t {
+  ResolveMode_SampleZero = 0, // always supported
+  ResolveMode_Average, // color only
+  ResolveMode_Min,
+  ResolveMode_Max,
+};
+
 enum ShaderStage : uint8_t {
   Stage_Vert,
   Stage_Tesc,
@@ -638,6 +671,8 @@ struct RenderPass final {
   struct AttachmentDesc final {
     LoadOp loadOp = LoadOp_Invalid;
     StoreOp storeOp = StoreOp_Store;
+    // depth modes which the device does not support fall back to ResolveMode_SampleZero
+    ResolveMode resolveMode = ResolveMode_Average;
     uint8_t layer = 0;
     uint8_t level = 0;
     float clearColor[4] = {0.0f, 0.0f, 0.0f, 0.0f};
@@ -649,6 +684,9 @@ struct RenderPass final {
   AttachmentDesc depth = {.loadOp = LoadOp_DontCare, .storeOp = StoreOp_DontCare};
   AttachmentDesc stencil = {.loadOp = LoadOp_Invalid, .storeOp = StoreOp_DontCare};
 
+  // the render pass contains only cmdExecuteBundle() calls, no other commands can be recorded into it
+  bool executesBundles = false;
+
   uint32_t getNumColorAttachments() const {
     uint32_t n = 0;
     while (n < LVK_MAX_COLOR_ATTACHMENTS && color[n].loadOp != LoadOp_Invalid) {
@@ -665,6 +703,7 @@ struct Framebuffer final {
   };
 
   AttachmentDesc color[LVK_MAX_COLOR_ATTACHMENTS] = {};
+  // a multisampled depth attachment is resolved into `depthStencil.resolveTexture` whenever it is set, independently of the store op
   AttachmentDesc depthStencil;
 
   const char* debugName = "";
@@ -692,6 +731,8 @@ struct BufferDesc final {
   size_t size = 0;
   const void* data = nullptr;
   const char* debugName = "";
+  // small buffers can be carved out of shared backing buffers instead of getting their own VkBuffer
+  bool suballocate = false;
 };
 
 struct TextureRangeDesc {
@@ -709,6 +750,8 @@ enum TextureUsageBits : uint8_t {
   TextureUsageBits_Sampled = 1 << 0,
   TextureUsageBits_Storage = 1 << 1,
   TextureUsageBits_Attachment = 1 << 2,
+  // attachments whose contents never leave a render pass (MSAA, depth); backed by lazily allocated memory when available
+  TextureUsageBits_Transient = 1 << 3,
 };
 
 enum Swizzle : uint8_t {
@@ -744,10 +787,73 @@ struct TextureDesc {
   const char* debugName = "";
 };
 
+// Textures with non-overlapping lifetime intervals [firstUse, lastUse] can share memory. The intervals are expressed in any monotonic
+// units, for example, render pass indices within a frame.
+struct AliasedTextureDesc {
+  TextureDesc desc;
+  uint32_t firstUse = 0;
+  uint32_t lastUse = 0;
+};
+
 struct Dependencies {
   enum { LVK_MAX_SUBMIT_DEPENDENCIES = 4 };
   TextureHandle textures[LVK_MAX_SUBMIT_DEPENDENCIES] = {};
   BufferHandle buffers[LVK_MAX_SUBMIT_DEPENDENCIES] = {};
+  // optional byte ranges of `buffers`, a zero size means "until the end of the buffer"; barriers are recorded only for ranges
+  // which overlap earlier accesses in the same command buffer (dispatches are assumed to write their buffer dependencies)
+  size_t bufferOffsets[LVK_MAX_SUBMIT_DEPENDENCIES] = {};
+  size_t bufferSizes[LVK_MAX_SUBMIT_DEPENDENCIES] = {};
+};
+
+// How a resource is accessed by GPU commands. Every bit implies pipeline stages, memory access types and, for textures, an image layout.
+enum ResourceAccessBits : uint32_t {
+  ResourceAccessBits_None = 0,
+  ResourceAccessBits_IndirectRead = 1 << 0,
+  ResourceAccessBits_IndexRead = 1 << 1,
+  ResourceAccessBits_VertexRead = 1 << 2,
+  // uniform and storage buffers, sampled textures; storage-only textures are read in the general layout
+  ResourceAccessBits_GraphicsShaderRead = 1 << 3,
+  ResourceAccessBits_GraphicsShaderWrite = 1 << 4,
+  ResourceAccessBits_ComputeShaderRead = 1 << 5,
+  ResourceAccessBits_ComputeShaderWrite = 1 << 6,
+  ResourceAccessBits_ColorAttachment = 1 << 7,
+  ResourceAccessBits_DepthAttachment = 1 << 8,
+  ResourceAccessBits_DepthAttachmentRead = 1 << 9, // read-only depth test
+  ResourceAccessBits_TransferRead = 1 << 10,
+  ResourceAccessBits_TransferWrite = 1 << 11,
+  ResourceAccessBits_Any = 1 << 12, // all commands, all memory accesses; the image layout is left unchanged
+};
+
+constexpr uint32_t kResourceAccessWriteBits = ResourceAccessBits_GraphicsShaderWrite | ResourceAccessBits_ComputeShaderWrite |
+                                              ResourceAccessBits_ColorAttachment | ResourceAccessBits_DepthAttachment |
+                                              ResourceAccessBits_TransferWrite | ResourceAccessBits_Any;
+
+// `before` are all accesses which have to complete, `after` are the accesses which wait for them
+struct BufferBarrier {
+  BufferHandle buffer;
+  uint32_t before = ResourceAccessBits_None; // ResourceAccessBits
+  uint32_t after = ResourceAccessBits_None; // ResourceAccessBits
+};
+
+// the texture is transitioned into the layout required by `after`; `discard` throws away the previous contents
+struct TextureBarrier {
+  TextureHandle texture;
+  uint32_t before = ResourceAccessBits_None; // ResourceAccessBits
+  uint32_t after = ResourceAccessBits_None; // ResourceAccessBits
+  bool discard = false;
+};
+
+// number of calls which did not reach the driver because the same state was already recorded into the command buffer
+struct CommandBufferStats {
+  uint32_t skippedPipelineBinds = 0;
+  uint32_t skippedVertexBufferBinds = 0;
+  uint32_t skippedIndexBufferBinds = 0;
+  uint32_t skippedViewports = 0;
+  uint32_t skippedScissorRects = 0;
+  uint32_t skippedDepthStates = 0;
+  uint32_t skippedDepthBiases = 0;
+  uint32_t skippedBlendColors = 0;
+  uint32_t skippedPushConstants = 0;
 };
 
 class ICommandBuffer {
@@ -762,6 +868,21 @@ class ICommandBuffer {
 
   virtual void cmdBindComputePipeline(lvk::ComputePipelineHandle handle) = 0;
   virtual void cmdDispatchThreadGroups(const Dimensions& threadgroupCount, const Dependencies& deps = {}) = 0;
+  // reads VkDispatchIndirectCommand {x, y, z} from `indirectBuffer` (usage BufferUsageBits_Indirect); writes from previous compute
+  // dispatches into it are made visible automatically
+  virtual void cmdDispatchThreadGroupsIndirect(BufferHandle indirectBuffer, size_t indirectBufferOffset, const Dependencies& deps = {}) = 0;
+  // all barriers are merged with the automatic ones and recorded as one batch before the next draw, dispatch or copy
+  virtual void cmdPipelineBarrier(const BufferBarrier* bufferBarriers,
+                                  uint32_t numBufferBarriers,
+                                  const TextureBarrier* textureBarriers,
+                                  uint32_t numTextureBarriers) = 0;
+  // hands the memory shared by aliased textures over from `from` to `to` (both from the same createAliasedTextures() call): the next
+  // barrier of `to` discards its contents and waits for the last access to `from`
+  virtual void cmdAliasTexture(TextureHandle from, TextureHandle to) = 0;
+  // when disabled, cmdBeginRendering() records no barriers for attachments and Dependencies; the caller is responsible for them
+  virtual void setAutomaticBarriers(bool enabled) = 0;
+  // fills `size` bytes with `data` outside of rendering; the write is visible to all subsequent commands
+  virtual void cmdFillBuffer(BufferHandle buffer, size_t bufferOffset, size_t size, uint32_t data) = 0;
 
   virtual void cmdBeginRendering(const lvk::RenderPass& renderPass, const lvk::Framebuffer& desc, const Dependencies& deps = {}) = 0;
   virtual void cmdEndRendering() = 0;
@@ -786,6 +907,13 @@ class ICommandBuffer {
                               uint32_t firstIndex = 0,
                               int32_t vertexOffset = 0,
                               uint32_t baseInstance = 0) = 0;
+  // many draws with the same state in one call: VK_EXT_multi_draw if available, otherwise an indirect draw from transient memory
+  // (separate draw calls inside command bundles, which outlive the transient memory)
+  virtual void cmdDrawMulti(const DrawInfo* draws, uint32_t numDraws, uint32_t instanceCount = 1, uint32_t baseInstance = 0) = 0;
+  virtual void cmdDrawIndexedMulti(const DrawIndexedInfo* draws,
+                                   uint32_t numDraws,
+                                   uint32_t instanceCount = 1,
+                                   uint32_t baseInstance = 0) = 0;
   virtual void cmdDrawIndirect(BufferHandle indirectBuffer, size_t indirectBufferOffset, uint32_t drawCount, uint32_t stride = 0) = 0;
   virtual void cmdDrawIndexedIndirect(BufferHandle indirectBuffer,
                                       size_t indirectBufferOffset,
@@ -803,6 +931,27 @@ class ICommandBuffer {
 
   virtual void cmdResetQueryPool(QueryPoolHandle pool, uint32_t firstQuery, uint32_t queryCount) = 0;
   virtual void cmdWriteTimestamp(QueryPoolHandle pool, uint32_t query) = 0;
+
+  // only inside render passes with `RenderPass::executesBundles`; bundles with stale pipelines are re-recorded first
+  virtual void cmdExecuteBundle(CommandBundleHandle bundle) = 0;
+
+  virtual CommandBufferStats getStats() const = 0;
+};
+
+// Binds and draws which are recorded once into a secondary command buffer and replayed with ICommandBuffer::cmdExecuteBundle().
+// The formats and the number of samples have to match the render pass the bundle is executed in. Nothing is inherited from that
+// render pass: `record` starts with the default depth state and the viewport and scissor rect set to `width` x `height` (when not 0).
+// `record` is called on the render thread by createCommandBundle() and again before execution whenever a render pipeline it bound was
+// rebuilt, so it has to stay callable for the lifetime of the bundle.
+struct CommandBundleDesc final {
+  Format color[LVK_MAX_COLOR_ATTACHMENTS] = {};
+  Format depthFormat = Format_Invalid;
+  Format stencilFormat = Format_Invalid;
+  uint32_t samplesCount = 1;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::function<void(ICommandBuffer& buffer)> record;
+  const char* debugName = "";
 };
 
 struct SubmitHandle {
@@ -822,6 +971,53 @@ struct SubmitHandle {
 
 static_assert(sizeof(SubmitHandle) == sizeof(uint64_t));
 
+// short-lived memory suballocated from a persistently mapped ring buffer; valid until the next submit() completes on the GPU
+struct TransientAllocation {
+  void* ptr = nullptr; // CPU pointer
+  uint64_t gpuAddress = 0; // buffer device address
+  BufferHandle buffer; // the ring buffer itself, can be used with cmdBindVertexBuffer() and cmdBindIndexBuffer()
+  size_t offset = 0; // offset inside `buffer`
+
+  bool valid() const {
+    return ptr != nullptr;
+  }
+};
+
+struct MemoryHeapStats {
+  uint64_t size = 0; // total size of the heap
+  uint64_t budget = 0; // how much this process can allocate from the heap (VK_EXT_memory_budget), or the heap size if not available
+  uint64_t usage = 0; // how much this process is using, including memory allocated outside LightweightVK
+  bool isDeviceLocal = false;
+};
+
+struct MemoryAllocationStats {
+  enum { LVK_MAX_DEBUG_NAME_SIZE = 64 };
+  char debugName[LVK_MAX_DEBUG_NAME_SIZE] = {0};
+  uint64_t size = 0;
+  bool isTexture = false;
+};
+
+struct MemoryStats {
+  enum { LVK_MAX_MEMORY_HEAPS = 16, LVK_MAX_LARGEST_ALLOCATIONS = 16 };
+  uint32_t numHeaps = 0;
+  MemoryHeapStats heaps[LVK_MAX_MEMORY_HEAPS] = {};
+  // per-resource-type totals; sub-allocated buffers are accounted by their backing buffers
+  uint32_t numBuffers = 0;
+  uint64_t buffersBytes = 0;
+  uint32_t numTextures = 0;
+  uint64_t texturesBytes = 0;
+  // staging buffer size and how much of it is still in use by the GPU
+  uint64_t stagingBytes = 0;
+  uint64_t stagingBytesInUse = 0;
+  // sorted by size, largest first
+  uint32_t numLargestAllocations = 0;
+  MemoryAllocationStats largestAllocations[LVK_MAX_LARGEST_ALLOCATIONS] = {};
+};
+
+// IContext is owned by the thread which created it (the render thread). Resources can also be created and destroyed from other threads:
+// create*(), destroy(), upload(), uploadFromFile() and generateMipmap() are thread-safe. GPU work they need (staging uploads, mip-maps)
+// is recorded by the render thread in the next acquireCommandBuffer() or submit(), before the submitted command buffer.
+// Everything else, including command buffers and download(), is available only on the render thread.
 class IContext {
  protected:
   IContext() = default;
@@ -834,6 +1030,16 @@ class IContext {
   virtual SubmitHandle submit(ICommandBuffer& commandBuffer, TextureHandle present = {}) = 0;
   virtual void wait(SubmitHandle handle) = 0;
 
+#pragma region Frame pacing
+  // beginFrame() waits until the GPU has finished the frame started `getNumFramesInFlight()` frames ago and returns the index of the new
+  // frame; everything that old frame used with the same index can be overwritten now (see FrameRing). endFrame() takes the last submit of
+  // the frame, an empty handle means the last submit so far.
+  virtual uint32_t beginFrame() = 0;
+  virtual void endFrame(SubmitHandle handle = {}) = 0;
+  [[nodiscard]] virtual uint32_t getFrameIndex() const = 0;
+  [[nodiscard]] virtual uint32_t getNumFramesInFlight() const = 0;
+#pragma endregion
+
   [[nodiscard]] virtual Holder<BufferHandle> createBuffer(const BufferDesc& desc, Result* outResult = nullptr) = 0;
   [[nodiscard]] virtual Holder<SamplerHandle> createSampler(const SamplerStateDesc& desc, Result* outResult = nullptr) = 0;
   [[nodiscard]] virtual Holder<TextureHandle> createTexture(const TextureDesc& desc,
@@ -847,6 +1053,8 @@ class IContext {
   [[nodiscard]] virtual Holder<QueryPoolHandle> createQueryPool(uint32_t numQueries,
                                                                 const char* debugName,
                                                                 Result* outResult = nullptr) = 0;
+  // render thread only
+  [[nodiscard]] virtual Holder<CommandBundleHandle> createCommandBundle(const CommandBundleDesc& desc, Result* outResult = nullptr) = 0;
 
   virtual void destroy(ComputePipelineHandle handle) = 0;
   virtual void destroy(RenderPipelineHandle handle) = 0;
@@ -855,6 +1063,7 @@ class IContext {
   virtual void destroy(BufferHandle handle) = 0;
   virtual void destroy(TextureHandle handle) = 0;
   virtual void destroy(QueryPoolHandle handle) = 0;
+  virtual void destroy(CommandBundleHandle handle) = 0;
   virtual void destroy(Framebuffer& fb) = 0;
 
 #pragma region Buffer functions
@@ -862,15 +1071,35 @@ class IContext {
   [[nodiscard]] virtual uint8_t* getMappedPtr(BufferHandle handle) const = 0;
   [[nodiscard]] virtual uint64_t gpuAddress(BufferHandle handle, size_t offset = 0) const = 0;
   virtual void flushMappedMemory(BufferHandle handle, size_t offset, size_t size) const = 0;
+  // memory-maps a file region and streams it into the buffer without intermediate heap copies; `size == 0` means till the end of the file
+  virtual Result uploadFromFile(BufferHandle handle, const char* fileName, size_t fileOffset, size_t size, size_t bufferOffset = 0) = 0;
+  // per-frame bump allocator for transient constants; memory is recycled automatically once the next submitted command buffer is done
+  [[nodiscard]] virtual TransientAllocation allocateTransient(size_t size, size_t alignment = 16) = 0;
+  template<typename Struct>
+  [[nodiscard]] TransientAllocation allocateTransient(const Struct& data, size_t alignment = 16) {
+    const TransientAllocation alloc = this->allocateTransient(sizeof(Struct), alignment);
+    if (alloc.valid()) {
+      memcpy(alloc.ptr, &data, sizeof(Struct));
+    }
+    return alloc;
+  }
 #pragma endregion
 
 #pragma region Texture functions
   // `data` contains mip-levels and layers as in https://registry.khronos.org/KTX/specs/1.0/ktxspec.v1.html
   virtual Result upload(TextureHandle handle, const TextureRangeDesc& range, const void* data) = 0;
   virtual Result download(TextureHandle handle, const TextureRangeDesc& range, void* outData) = 0;
+  virtual Result uploadFromFile(TextureHandle handle, const TextureRangeDesc& range, const char* fileName, size_t fileOffset) = 0;
+  // places all textures into one memory allocation; the contents of an aliased texture are undefined at the start of its lifetime interval
+  // and it has to be handed the memory with ICommandBuffer::cmdAliasTexture() unless a render graph or explicit barriers synchronize it
+  virtual Result createAliasedTextures(const AliasedTextureDesc* descs,
+                                       uint32_t numTextures,
+                                       Holder<TextureHandle>* outTextures,
+                                       const char* debugName = nullptr) = 0;
   virtual void generateMipmap(TextureHandle handle) const = 0;
   [[nodiscard]] virtual Dimensions getDimensions(TextureHandle handle) const = 0;
   [[nodiscard]] virtual Format getFormat(TextureHandle handle) const = 0;
+  [[nodiscard]] virtual uint8_t getTextureUsage(TextureHandle handle) const = 0; // TextureUsageBits
 #pragma endregion
 
   virtual TextureHandle getCurrentSwapchainTexture() = 0;
@@ -878,6 +1107,14 @@ class IContext {
   virtual ColorSpace getSwapChainColorSpace() const = 0;
   virtual uint32_t getNumSwapchainImages() const = 0;
   virtual void recreateSwapchain(int newWidth, int newHeight) = 0;
+  // with VK_KHR_present_id and VK_KHR_present_wait (or a headless context) every present gets an increasing ID; 0 if not supported
+  [[nodiscard]] virtual uint64_t getLastPresentId() const = 0;
+  // blocks until the image presented with `presentId` is shown; false on timeout or if present IDs are not supported
+  virtual bool waitForPresent(uint64_t presentId, uint64_t timeoutNanoseconds = UINT64_MAX) = 0;
+  // Headless contexts with ContextConfig::readbackVirtualSwapchain: copies the oldest presented frame which has not been read yet
+  // and whose GPU copy has finished into `outData` (tightly packed RGBA, 4 bytes per pixel). Never blocks. Returns the present ID of
+  // the frame or 0 if none is ready. Frames which are not read before their swapchain image is presented again are dropped.
+  virtual uint64_t readbackPresentedImage(void* outData, size_t sizeInBytes) = 0;
 
   // MSAA level is supported if ((samples & bitmask) != 0), where samples must be power of two.
   virtual uint32_t getFramebufferMSAABitMask() const = 0;
@@ -890,9 +1127,45 @@ class IContext {
                                    size_t dataSize,
                                    void* outData,
                                    size_t stride) const = 0;
+  [[nodiscard]] virtual MemoryStats getMemoryStats() const = 0;
 #pragma endregion
 };
 
+// One object per frame in flight, e.g. uniform buffers which are rewritten every frame. current() belongs to the frame started by the
+// last IContext::beginFrame(), so the GPU is done with it.
+template<typename T>
+class FrameRing final {
+ public:
+  FrameRing() = default;
+  // `create(i)` is called for every frame index
+  template<typename CreateFn>
+  FrameRing(IContext* ctx, CreateFn&& create) : ctx_(ctx) {
+    for (uint32_t i = 0; i != ctx_->getNumFramesInFlight(); i++) {
+      items_[i] = create(i);
+    }
+  }
+
+  T& current() {
+    return items_[ctx_->getFrameIndex()];
+  }
+  const T& current() const {
+    return items_[ctx_->getFrameIndex()];
+  }
+  T& operator[](uint32_t frameIndex) {
+    return items_[frameIndex];
+  }
+  const T& operator[](uint32_t frameIndex) const {
+    return items_[frameIndex];
+  }
+  uint32_t size() const {
+    return ctx_ ? ctx_->getNumFramesInFlight() : 0;
+  }
+
+ private:
+  IContext* ctx_ = nullptr;
+  T items_[LVK_MAX_FRAMES_IN_FLIGHT] = {};
+};
+
 } // namespace lvk
 
 #if LVK_WITH_GLFW
@@ -902,6 +1175,7 @@ typedef struct GLFWwindow GLFWwindow;
 namespace lvk {
 
 using ShaderModuleErrorCallback = void (*)(lvk::IContext*, lvk::ShaderModuleHandle, int line, int col, const char* debugName);
+using MemoryBudgetCallback = void (*)(lvk::IContext*, uint32_t heapIndex, const lvk::MemoryHeapStats& heap);
 
 #ifdef LVK_WITH_OPENXR
 struct XRParams;
@@ -911,10 +1185,26 @@ struct ContextConfig {
   bool terminateOnValidationError = false; // invoke std::terminate() on any validation error
   bool enableValidation = true;
   lvk::ColorSpace swapChainColorSpace = lvk::ColorSpace_SRGB_LINEAR;
+  lvk::PresentMode presentMode = lvk::PresentMode_Auto;
   // owned by the application - should be alive until createVulkanContextWithSwapchain() returns
   const void* pipelineCacheData = nullptr;
   size_t pipelineCacheDataSize = 0;
   ShaderModuleErrorCallback shaderModuleErrorCallback = nullptr;
+  size_t transientBufferSize = 8 * 1024 * 1024; // the ring buffer behind IContext::allocateTransient() is created on first use
+  // invoked from submit() once the usage of a memory heap goes above `memoryBudgetThreshold * budget`; re-armed when it drops below
+  // submit() checks only the heap budgets; call IContext::getMemoryStats() from the callback to find the largest allocations
+  MemoryBudgetCallback memoryBudgetCallback = nullptr;
+  float memoryBudgetThreshold = 0.9f;
+  // at most this many retired Vulkan objects are destroyed per submit(), the rest are carried over to the next frames; 0 is unlimited
+  uint32_t maxRetiredObjectsPerFrame = 1024;
+  // destroy retired Vulkan objects on a background thread instead of inside submit()
+  bool retireOnBackgroundThread = false;
+  // how many frames the CPU can run ahead of the GPU between IContext::beginFrame() calls, up to LVK_MAX_FRAMES_IN_FLIGHT
+  uint32_t numFramesInFlight = 3;
+  // headless contexts: the number of offscreen images behind getCurrentSwapchainTexture(), up to 16
+  uint32_t numVirtualSwapchainImages = 3;
+  // headless contexts: copy every presented image into a host-visible ring, see IContext::readbackPresentedImage()
+  bool readbackVirtualSwapchain = false;
 
 #ifdef LVK_WITH_OPENXR
   XRParams* xrParams;
@@ -950,4 +1240,14 @@ std::unique_ptr<lvk::IContext> createVulkanContextWithSwapchain(ANativeWindow* w
                                                                 lvk::HWDeviceType preferredDeviceType = lvk::HWDeviceType_Discrete);
 #endif
 
+/*
+ * No window and no surface extensions. If width/height > 0, getCurrentSwapchainTexture() and submit(present) cycle through
+ * ContextConfig::numVirtualSwapchainImages offscreen textures. Falls back to any device (for example, a software ICD) if
+ * neither a discrete nor an integrated GPU is found.
+ */
+std::unique_ptr<lvk::IContext> createVulkanContextHeadless(uint32_t width,
+                                                           uint32_t height,
+                                                           const lvk::ContextConfig& cfg,
+                                                           lvk::HWDeviceType preferredDeviceType = lvk::HWDeviceType_Discrete);
+
 } // namespace lvk
@@ -2,51 +2,127 @@
 
 #include <assert.h>
 #include <cstdint>
-#include <vector>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
 
 #include "lvk/LVK.h"
 
 /// Pool<> is used only by the implementation
 namespace lvk {
 
-template<typename ObjectType, typename ImplObjectType>
+// used when a pool has no rarely accessed (cold) data
+struct PoolNoColdData {};
+
+/*
+ * Objects live in fixed-size chunks, so their addresses are stable and growing the pool never moves them. Generations and free-list
+ * links are kept in separate dense arrays, so validating a handle does not touch the object itself. Rarely accessed data can be split
+ * into `ColdObjectType` which is stored in a parallel array of chunks.
+ * An optional hashed reverse index maps keys derived from objects (e.g. Vulkan handles) back to handles in O(1).
+ *
+ * Chunks are found through a 2-level directory: a fixed-size root array of lazily allocated blocks of chunk pointers. A pool holds up
+ * to 2^24 objects (16M) while an empty pool costs only the root array.
+ *
+ * Pool<> itself is not synchronized. Neither the root array nor the blocks are ever reallocated, so get() of a live handle does not race
+ * with create()/destroy() of other objects, as long as all mutating calls and iterations are externally serialized.
+ */
+template<typename ObjectType, typename ImplObjectType, typename ColdObjectType = PoolNoColdData>
 class Pool {
   static constexpr uint32_t kListEndSentinel = 0xffffffff;
-  struct PoolEntry {
-    explicit PoolEntry(ImplObjectType& obj) : obj_(std::move(obj)) {}
-    ImplObjectType obj_ = {};
-    uint32_t gen_ = 1;
-    uint32_t nextFree_ = kListEndSentinel;
+  static constexpr uint32_t kChunkSizeLog2 = 8;
+  static constexpr uint32_t kChunkSize = 1u << kChunkSizeLog2;
+  static constexpr uint32_t kBlockSizeLog2 = 8; // chunks per directory block
+  static constexpr uint32_t kBlockSize = 1u << kBlockSizeLog2;
+  static constexpr uint32_t kMaxBlocks = 256;
+  static constexpr uint32_t kMaxChunks = kMaxBlocks * kBlockSize;
+  static constexpr bool kHasColdData = !std::is_same_v<ColdObjectType, PoolNoColdData>;
+
+  struct Chunk {
+    std::unique_ptr<ImplObjectType[]> objects;
+    std::unique_ptr<ColdObjectType[]> cold;
+    std::unique_ptr<uint32_t[]> gens;
+    std::unique_ptr<uint32_t[]> nextFree;
   };
+
+  std::unique_ptr<Chunk[]> blocks_[kMaxBlocks];
   uint32_t freeListHead_ = kListEndSentinel;
+  uint32_t numSlots_ = 0;
   uint32_t numObjects_ = 0;
 
  public:
-  std::vector<PoolEntry> objects_;
+  static constexpr uint32_t kMaxObjects = kMaxChunks * kChunkSize;
+  // the key of an object must not change while it is in the pool; zero keys are not indexed
+  using ReverseKeyFn = uint64_t (*)(const ImplObjectType&);
 
-  Handle<ObjectType> create(ImplObjectType&& obj) {
+ private:
+  ReverseKeyFn reverseKeyFn_ = nullptr;
+  std::unordered_map<uint64_t, uint32_t> reverseIndex_;
+
+ public:
+  void enableReverseIndex(ReverseKeyFn fn) {
+    assert(numObjects_ == 0);
+    reverseKeyFn_ = fn;
+  }
+  Handle<ObjectType> create(ImplObjectType&& obj, ColdObjectType&& cold = {}) {
     uint32_t idx = 0;
     if (freeListHead_ != kListEndSentinel) {
       idx = freeListHead_;
-      freeListHead_ = objects_[idx].nextFree_;
-      objects_[idx].obj_ = std::move(obj);
+      freeListHead_ = nextFreeAt(idx);
+      nextFreeAt(idx) = kListEndSentinel;
     } else {
-      idx = (uint32_t)objects_.size();
-      objects_.emplace_back(obj);
+      idx = numSlots_;
+      const uint32_t chunk = idx >> kChunkSizeLog2;
+      if ((idx & (kChunkSize - 1)) == 0) {
+        assert(chunk < kMaxChunks); // more than 2^24 objects
+        if (chunk >= kMaxChunks)
+          return {};
+        std::unique_ptr<Chunk[]>& block = blocks_[chunk >> kBlockSizeLog2];
+        if (!block) {
+          block.reset(new Chunk[kBlockSize]);
+        }
+        Chunk& c = block[chunk & (kBlockSize - 1)];
+        c.objects.reset(new ImplObjectType[kChunkSize]);
+        if constexpr (kHasColdData) {
+          c.cold.reset(new ColdObjectType[kChunkSize]);
+        }
+        c.gens.reset(new uint32_t[kChunkSize]);
+        c.nextFree.reset(new uint32_t[kChunkSize]);
+      }
+      genAt(idx) = 1;
+      nextFreeAt(idx) = kListEndSentinel;
+      numSlots_++;
+    }
+    objectAt(idx) = std::move(obj);
+    if constexpr (kHasColdData) {
+      coldAt(idx) = std::move(cold);
+    }
+    if (reverseKeyFn_) {
+      if (const uint64_t key = reverseKeyFn_(objectAt(idx))) {
+        reverseIndex_.emplace(key, idx); // the first object owning a key wins
+      }
     }
     numObjects_++;
-    return Handle<ObjectType>(idx, objects_[idx].gen_);
+    return Handle<ObjectType>(idx, genAt(idx));
   }
   void destroy(Handle<ObjectType> handle) {
     if (handle.empty())
       return;
     assert(numObjects_ > 0); // double deletion
     const uint32_t index = handle.index();
-    assert(index < objects_.size());
-    assert(handle.gen() == objects_[index].gen_); // double deletion
-    objects_[index].obj_ = ImplObjectType{};
-    objects_[index].gen_++;
-    objects_[index].nextFree_ = freeListHead_;
+    assert(isValidSlot(index));
+    assert(handle.gen() == genAt(index)); // double deletion
+    if (reverseKeyFn_) {
+      const auto it = reverseIndex_.find(reverseKeyFn_(objectAt(index)));
+      if (it != reverseIndex_.end() && it->second == index) {
+        reverseIndex_.erase(it);
+      }
+    }
+    objectAt(index) = ImplObjectType{};
+    if constexpr (kHasColdData) {
+      coldAt(index) = ColdObjectType{};
+    }
+    genAt(index)++;
+    nextFreeAt(index) = freeListHead_;
     freeListHead_ = index;
     numObjects_--;
   }
@@ -55,46 +131,111 @@ class Pool {
       return nullptr;
 
     const uint32_t index = handle.index();
-    assert(index < objects_.size());
-    assert(handle.gen() == objects_[index].gen_); // accessing deleted object
-    return &objects_[index].obj_;
+    assert(isValidSlot(index));
+    assert(handle.gen() == genAt(index)); // accessing deleted object
+    return &objectAt(index);
   }
   ImplObjectType* get(Handle<ObjectType> handle) {
     if (handle.empty())
       return nullptr;
 
     const uint32_t index = handle.index();
-    assert(index < objects_.size());
-    assert(handle.gen() == objects_[index].gen_); // accessing deleted object
-    return &objects_[index].obj_;
+    assert(isValidSlot(index));
+    assert(handle.gen() == genAt(index)); // accessing deleted object
+    return &objectAt(index);
+  }
+  ColdObjectType* getCold(Handle<ObjectType> handle) {
+    static_assert(kHasColdData);
+    if (handle.empty())
+      return nullptr;
+
+    const uint32_t index = handle.index();
+    assert(isValidSlot(index));
+    assert(handle.gen() == genAt(index)); // accessing deleted object
+    return &coldAt(index);
+  }
+  // unlike get(), does not assert on stale handles
+  bool isAlive(Handle<ObjectType> handle) const {
+    return !handle.empty() && isValidSlot(handle.index()) && handle.gen() == genAt(handle.index());
   }
   Handle<ObjectType> getHandle(uint32_t index) const {
-    assert(index < objects_.size());
-    if (index >= objects_.size())
+    assert(index < numSlots_);
+    if (index >= numSlots_)
       return {};
 
-    return Handle<ObjectType>(index, objects_[index].gen_);
+    return Handle<ObjectType>(index, genAt(index));
+  }
+  Handle<ObjectType> findObjectByKey(uint64_t key) const {
+    assert(reverseKeyFn_);
+    const auto it = reverseIndex_.find(key);
+    return it != reverseIndex_.end() ? Handle<ObjectType>(it->second, genAt(it->second)) : Handle<ObjectType>();
   }
   Handle<ObjectType> findObject(const ImplObjectType* obj) {
     if (!obj)
       return {};
 
-    for (size_t idx = 0; idx != objects_.size(); idx++) {
-      if (objects_[idx].obj_ == *obj) {
-        return Handle<ObjectType>((uint32_t)idx, objects_[idx].gen_);
+    if (reverseKeyFn_) {
+      return findObjectByKey(reverseKeyFn_(*obj));
+    }
+
+    for (uint32_t idx = 0; idx != numSlots(); idx++) {
+      if (objectAt(idx) == *obj) {
+        return Handle<ObjectType>(idx, genAt(idx));
       }
     }
 
     return {};
   }
+  // raw access to slots [0...numSlots()); free slots contain default-constructed objects
+  ImplObjectType& objectAt(uint32_t index) {
+    return chunkAt(index).objects[index & (kChunkSize - 1)];
+  }
+  const ImplObjectType& objectAt(uint32_t index) const {
+    return chunkAt(index).objects[index & (kChunkSize - 1)];
+  }
+  ColdObjectType& coldAt(uint32_t index) {
+    return chunkAt(index).cold[index & (kChunkSize - 1)];
+  }
+  const ColdObjectType& coldAt(uint32_t index) const {
+    return chunkAt(index).cold[index & (kChunkSize - 1)];
+  }
   void clear() {
-    objects_.clear();
+    for (std::unique_ptr<Chunk[]>& block : blocks_) {
+      block.reset();
+    }
+    reverseIndex_.clear();
     freeListHead_ = kListEndSentinel;
     numObjects_ = 0;
+    numSlots_ = 0;
   }
   uint32_t numObjects() const {
     return numObjects_;
   }
+  uint32_t numSlots() const {
+    return numSlots_;
+  }
+
+ private:
+  // only checks that the slot has been allocated at some point; does not read `numSlots_` which is mutated by create()
+  bool isValidSlot(uint32_t index) const {
+    const uint32_t chunk = index >> kChunkSizeLog2;
+    return chunk < kMaxChunks && blocks_[chunk >> kBlockSizeLog2] != nullptr && chunkAt(index).gens != nullptr;
+  }
+  Chunk& chunkAt(uint32_t index) {
+    return blocks_[index >> (kChunkSizeLog2 + kBlockSizeLog2)][(index >> kChunkSizeLog2) & (kBlockSize - 1)];
+  }
+  const Chunk& chunkAt(uint32_t index) const {
+    return blocks_[index >> (kChunkSizeLog2 + kBlockSizeLog2)][(index >> kChunkSizeLog2) & (kBlockSize - 1)];
+  }
+  uint32_t& genAt(uint32_t index) {
+    return chunkAt(index).gens[index & (kChunkSize - 1)];
+  }
+  uint32_t genAt(uint32_t index) const {
+    return chunkAt(index).gens[index & (kChunkSize - 1)];
+  }
+  uint32_t& nextFreeAt(uint32_t index) {
+    return chunkAt(index).nextFree[index & (kChunkSize - 1)];
+  }
 };
 
 } // namespace lvk
@@ -5,9 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstring>
 #include <deque>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <vector>
 
 #define VMA_IMPLEMENTATION
@@ -24,6 +28,20 @@
 #include <unistd.h>
 #endif
 
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #if !defined(__APPLE__)
 #include <malloc.h>
 #endif
@@ -43,6 +61,10 @@ namespace {
 
 const char* kDefaultValidationLayers[] = {"VK_LAYER_KHRONOS_validation"};
 
+// sub-allocated buffers are carved out of backing buffers of this size
+const VkDeviceSize kSuballocationBlockSize = 4 * 1024 * 1024;
+const VkDeviceSize kMaxSuballocationSize = 256 * 1024;
+
 // These bindings should match GLSL declarations injected into shaders in VulkanContext::createShaderModule().
 enum Bindings {
   kBinding_Textures = 0,
@@ -202,6 +224,109 @@ VkAttachmentStoreOp storeOpToVkAttachmentStoreOp(lvk::StoreOp a) {
   return VK_ATTACHMENT_STORE_OP_DONT_CARE;
 }
 
+VkResolveModeFlagBits resolveModeToVkResolveModeFlagBits(lvk::ResolveMode mode, VkResolveModeFlags supported) {
+  VkResolveModeFlagBits result = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+  switch (mode) {
+  case lvk::ResolveMode_SampleZero:
+    result = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+    break;
+  case lvk::ResolveMode_Average:
+    result = VK_RESOLVE_MODE_AVERAGE_BIT;
+    break;
+  case lvk::ResolveMode_Min:
+    result = VK_RESOLVE_MODE_MIN_BIT;
+    break;
+  case lvk::ResolveMode_Max:
+    result = VK_RESOLVE_MODE_MAX_BIT;
+    break;
+  }
+  return (supported & result) ? result : VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+}
+
+VkPipelineStageFlags2 resourceAccessToVkPipelineStageFlags2(uint32_t access) {
+  VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+
+  if (access & lvk::ResourceAccessBits_IndirectRead)
+    stages |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+  if (access & lvk::ResourceAccessBits_IndexRead)
+    stages |= VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT;
+  if (access & lvk::ResourceAccessBits_VertexRead)
+    stages |= VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT;
+  if (access & (lvk::ResourceAccessBits_GraphicsShaderRead | lvk::ResourceAccessBits_GraphicsShaderWrite))
+    stages |= VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+  if (access & (lvk::ResourceAccessBits_ComputeShaderRead | lvk::ResourceAccessBits_ComputeShaderWrite))
+    stages |= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+  if (access & lvk::ResourceAccessBits_ColorAttachment)
+    stages |= VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+  if (access & (lvk::ResourceAccessBits_DepthAttachment | lvk::ResourceAccessBits_DepthAttachmentRead))
+    stages |= VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+  if (access & (lvk::ResourceAccessBits_TransferRead | lvk::ResourceAccessBits_TransferWrite))
+    stages |= VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+  if (access & lvk::ResourceAccessBits_Any)
+    stages |= VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+  return stages;
+}
+
+VkAccessFlags2 resourceAccessToVkAccessFlags2(uint32_t access) {
+  VkAccessFlags2 flags = VK_ACCESS_2_NONE;
+
+  if (access & lvk::ResourceAccessBits_IndirectRead)
+    flags |= VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+  if (access & lvk::ResourceAccessBits_IndexRead)
+    flags |= VK_ACCESS_2_INDEX_READ_BIT;
+  if (access & lvk::ResourceAccessBits_VertexRead)
+    flags |= VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT;
+  if (access & (lvk::ResourceAccessBits_GraphicsShaderRead | lvk::ResourceAccessBits_ComputeShaderRead))
+    flags |= VK_ACCESS_2_SHADER_READ_BIT;
+  if (access & (lvk::ResourceAccessBits_GraphicsShaderWrite | lvk::ResourceAccessBits_ComputeShaderWrite))
+    flags |= VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT;
+  if (access & lvk::ResourceAccessBits_ColorAttachment)
+    flags |= VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+  if (access & lvk::ResourceAccessBits_DepthAttachment)
+    flags |= VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  if (access & lvk::ResourceAccessBits_DepthAttachmentRead)
+    flags |= VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+  if (access & lvk::ResourceAccessBits_TransferRead)
+    flags |= VK_ACCESS_2_TRANSFER_READ_BIT;
+  if (access & lvk::ResourceAccessBits_TransferWrite)
+    flags |= VK_ACCESS_2_TRANSFER_WRITE_BIT;
+  if (access & lvk::ResourceAccessBits_Any)
+    flags |= VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+  return flags;
+}
+
+// VK_IMAGE_LAYOUT_UNDEFINED means "keep the current layout"
+VkImageLayout resourceAccessToVkImageLayout(uint32_t access, bool isSampledImage) {
+  VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  auto use = [&layout](VkImageLayout l) {
+    LVK_ASSERT_MSG(layout == VK_IMAGE_LAYOUT_UNDEFINED || layout == l, "Incompatible texture accesses in one barrier");
+    layout = l;
+  };
+
+  if (access & (lvk::ResourceAccessBits_GraphicsShaderWrite | lvk::ResourceAccessBits_ComputeShaderWrite)) {
+    use(VK_IMAGE_LAYOUT_GENERAL);
+    // storage images can be read in the general layout as well
+    access &= ~(lvk::ResourceAccessBits_GraphicsShaderRead | lvk::ResourceAccessBits_ComputeShaderRead);
+  }
+  if (access & (lvk::ResourceAccessBits_GraphicsShaderRead | lvk::ResourceAccessBits_ComputeShaderRead))
+    use(isSampledImage ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL);
+  if (access & lvk::ResourceAccessBits_ColorAttachment)
+    use(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  if (access & lvk::ResourceAccessBits_DepthAttachment)
+    use(VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+  if (access & lvk::ResourceAccessBits_DepthAttachmentRead)
+    use(VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+  if (access & lvk::ResourceAccessBits_TransferRead)
+    use(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+  if (access & lvk::ResourceAccessBits_TransferWrite)
+    use(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+  return layout;
+}
+
 VkShaderStageFlagBits shaderStageToVkShaderStage(lvk::ShaderStage stage) {
   switch (stage) {
   case lvk::Stage_Vert:
@@ -573,7 +698,8 @@ bool hasExtension(const char* ext, const std::vector<VkExtensionProperties>& pro
   return false;
 }
 
-void transitionToColorAttachment(VkCommandBuffer buffer, lvk::VulkanImage* colorTex) {
+// only the rendered level/layer changes its layout, all other subresources keep theirs
+void transitionToColorAttachment(lvk::VulkanBarrierBatch& batch, lvk::VulkanImage* colorTex, uint32_t level, uint32_t layer) {
   if (!LVK_VERIFY(colorTex)) {
     return;
   }
@@ -583,12 +709,12 @@ void transitionToColorAttachment(VkCommandBuffer buffer, lvk::VulkanImage* color
     return;
   }
   LVK_ASSERT_MSG(colorTex->vkImageFormat_ != VK_FORMAT_UNDEFINED, "Invalid color attachment format");
-  colorTex->transitionLayout(buffer,
+  colorTex->transitionLayout(batch,
                              VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
                              VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
                              VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // wait for all subsequent
                                                                                                            // fragment/compute shaders
-                             VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+                             VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, level, 1, layer, 1});
 }
 
 bool isDepthOrStencilVkFormat(VkFormat format) {
@@ -660,6 +786,141 @@ VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>
   return formats[0];
 }
 
+// read-only memory mapping of a file region; the OS pages data in on demand, so no intermediate heap copies are needed
+class MappedFileRegion final {
+ public:
+  MappedFileRegion() = default;
+  ~MappedFileRegion() {
+    unmap();
+  }
+  MappedFileRegion(const MappedFileRegion&) = delete;
+  MappedFileRegion& operator=(const MappedFileRegion&) = delete;
+  MappedFileRegion(MappedFileRegion&& other) noexcept {
+    *this = std::move(other);
+  }
+  MappedFileRegion& operator=(MappedFileRegion&& other) noexcept {
+    if (this != &other) {
+      unmap();
+      std::swap(ptr_, other.ptr_);
+      std::swap(delta_, other.delta_);
+      std::swap(mappedSize_, other.mappedSize_);
+      std::swap(size_, other.size_);
+    }
+    return *this;
+  }
+
+  // `size == 0` maps everything from `offset` till the end of the file
+  lvk::Result map(const char* fileName, size_t offset, size_t size) {
+    LVK_PROFILER_FUNCTION();
+
+    unmap();
+
+    if (!fileName || !*fileName) {
+      return lvk::Result(lvk::Result::Code::ArgumentOutOfRange, "Empty file name");
+    }
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      return lvk::Result(lvk::Result::Code::RuntimeError, "Cannot open file");
+    }
+    SCOPE_EXIT {
+      CloseHandle(file);
+    };
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(file, &fileSize)) {
+      return lvk::Result(lvk::Result::Code::RuntimeError, "Cannot get file size");
+    }
+    const size_t totalSize = (size_t)fileSize.QuadPart;
+    SYSTEM_INFO sysInfo = {};
+    GetSystemInfo(&sysInfo);
+    const size_t granularity = sysInfo.dwAllocationGranularity;
+#else
+    const int fd = open(fileName, O_RDONLY);
+    if (fd < 0) {
+      return lvk::Result(lvk::Result::Code::RuntimeError, "Cannot open file");
+    }
+    SCOPE_EXIT {
+      close(fd);
+    };
+    struct stat st = {};
+    if (fstat(fd, &st) != 0) {
+      return lvk::Result(lvk::Result::Code::RuntimeError, "Cannot get file size");
+    }
+    const size_t totalSize = (size_t)st.st_size;
+    const size_t granularity = (size_t)sysconf(_SC_PAGESIZE);
+#endif // _WIN32
+
+    if (offset >= totalSize) {
+      return lvk::Result(lvk::Result::Code::ArgumentOutOfRange, "File offset is out of range");
+    }
+    if (!size) {
+      size = totalSize - offset;
+    }
+    if (size > totalSize - offset) {
+      return lvk::Result(lvk::Result::Code::ArgumentOutOfRange, "File region is out of range");
+    }
+
+    // mapping offsets should be aligned to the allocation granularity
+    const size_t alignedOffset = offset & ~(granularity - 1);
+    delta_ = offset - alignedOffset;
+    mappedSize_ = size + delta_;
+    size_ = size;
+
+#if defined(_WIN32)
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+      return lvk::Result(lvk::Result::Code::RuntimeError, "Cannot create file mapping");
+    }
+    // the view keeps the mapping object alive
+    ptr_ = (uint8_t*)MapViewOfFile(
+        mapping, FILE_MAP_READ, (DWORD)((uint64_t)alignedOffset >> 32), (DWORD)(alignedOffset & 0xFFFFFFFF), mappedSize_);
+    CloseHandle(mapping);
+    if (!ptr_) {
+      return lvk::Result(lvk::Result::Code::RuntimeError, "Cannot map file");
+    }
+#else
+    void* ptr = mmap(nullptr, mappedSize_, PROT_READ, MAP_PRIVATE, fd, (off_t)alignedOffset);
+    if (ptr == MAP_FAILED) {
+      return lvk::Result(lvk::Result::Code::RuntimeError, "Cannot map file");
+    }
+    ptr_ = (uint8_t*)ptr;
+    // we are going to stream the data once front-to-back
+    madvise(ptr, mappedSize_, MADV_SEQUENTIAL);
+#endif // _WIN32
+
+    return lvk::Result();
+  }
+
+  void unmap() {
+    if (!ptr_) {
+      return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(ptr_);
+#else
+    munmap(ptr_, mappedSize_);
+#endif // _WIN32
+    ptr_ = nullptr;
+    delta_ = 0;
+    mappedSize_ = 0;
+    size_ = 0;
+  }
+
+  const uint8_t* data() const {
+    return ptr_ ? ptr_ + delta_ : nullptr;
+  }
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  uint8_t* ptr_ = nullptr;
+  size_t delta_ = 0;
+  size_t mappedSize_ = 0;
+  size_t size_ = 0;
+};
+
 } // namespace
 
 namespace lvk {
@@ -670,6 +931,41 @@ struct DeferredTask {
   SubmitHandle handle_;
 };
 
+// a Vulkan object waiting for the GPU to finish using it; plain data, so retiring objects does not allocate in the steady state
+struct RetiredObject {
+  RetiredObjectType type = RetiredObjectType_ImageView;
+  uint64_t handle = 0;
+  uint64_t extra = 0; // memory or allocation which goes together with `handle`
+  SubmitHandle submitHandle;
+};
+
+// an upload or mip-map generation requested from a thread other than the render thread
+struct DeferredUpload {
+  BufferHandle buffer;
+  TextureHandle texture;
+  TextureRangeDesc range = {};
+  size_t offset = 0;
+  bool generateMipmap = false;
+  std::vector<uint8_t> data;
+  // uploadFromFile() keeps the file mapped until the render thread streams it, instead of copying it into `data`
+  MappedFileRegion file;
+
+  const void* getData() const {
+    return file.data() ? (const void*)file.data() : data.data();
+  }
+  size_t getSize() const {
+    return file.data() ? file.size() : data.size();
+  }
+};
+
+// a large backing buffer which small sub-allocated buffers with identical usage and memory flags are carved out of
+struct BufferSuballocationBlock {
+  BufferHandle buffer_;
+  VkBufferUsageFlags usageFlags_ = 0;
+  VkMemoryPropertyFlags memFlags_ = 0;
+  VmaVirtualBlock vmaVirtualBlock_ = VK_NULL_HANDLE;
+};
+
 struct VulkanContextImpl final {
   // Vulkan Memory Allocator
   VmaAllocator vma_ = VK_NULL_HANDLE;
@@ -677,6 +973,32 @@ struct VulkanContextImpl final {
   lvk::CommandBuffer currentCommandBuffer_;
 
   mutable std::deque<DeferredTask> deferredTasks_;
+
+  // FIFO ordered by submit handles; [retiredHead_, retired_.size()) are still alive and the storage is reused
+  std::vector<RetiredObject> retired_;
+  size_t retiredHead_ = 0;
+
+  // optional background thread which destroys retired objects handed over by the render thread
+  std::thread retireThread_;
+  std::mutex retireMutex_;
+  std::condition_variable retireThreadCondition_;
+  std::vector<RetiredObject> retireThreadQueue_;
+  bool retireThreadBusy_ = false;
+  bool retireThreadExit_ = false;
+
+  // the thread which created the context; it owns command buffers, the staging device and submit handles
+  std::thread::id renderThreadId_ = std::this_thread::get_id();
+  // guards all pools, sub-allocation blocks and the reverse indices
+  mutable std::recursive_mutex resourcesMutex_;
+  // guards the work handed over from other threads to the render thread
+  std::mutex pendingMutex_;
+  std::vector<DeferredTask> pendingDeferredTasks_;
+  std::vector<RetiredObject> pendingRetired_;
+  std::vector<DeferredUpload> pendingUploads_;
+
+  std::vector<BufferSuballocationBlock> suballocationBlocks_;
+
+  bool isHeapAboveBudgetThreshold_[MemoryStats::LVK_MAX_MEMORY_HEAPS] = {};
 };
 
 } // namespace lvk
@@ -687,12 +1009,12 @@ void lvk::VulkanBuffer::flushMappedMemory(const VulkanContext& ctx, VkDeviceSize
   }
 
   if (LVK_VULKAN_USE_VMA) {
-    vmaFlushAllocation((VmaAllocator)ctx.getVmaAllocator(), vmaAllocation_, offset, size);
+    vmaFlushAllocation((VmaAllocator)ctx.getVmaAllocator(), metadata_->vmaAllocation_, bufferOffset_ + offset, size);
   } else {
     const VkMappedMemoryRange range = {
         .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-        .memory = vkMemory_,
-        .offset = offset,
+        .memory = metadata_->vkMemory_,
+        .offset = bufferOffset_ + offset,
         .size = size,
     };
     vkFlushMappedMemoryRanges(ctx.getVkDevice(), 1, &range);
@@ -705,12 +1027,12 @@ void lvk::VulkanBuffer::invalidateMappedMemory(const VulkanContext& ctx, VkDevic
   }
 
   if (LVK_VULKAN_USE_VMA) {
-    vmaInvalidateAllocation(static_cast<VmaAllocator>(ctx.getVmaAllocator()), vmaAllocation_, offset, size);
+    vmaInvalidateAllocation(static_cast<VmaAllocator>(ctx.getVmaAllocator()), metadata_->vmaAllocation_, bufferOffset_ + offset, size);
   } else {
     const VkMappedMemoryRange range = {
         .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-        .memory = vkMemory_,
-        .offset = offset,
+        .memory = metadata_->vkMemory_,
+        .offset = bufferOffset_ + offset,
         .size = size,
     };
     vkInvalidateMappedMemoryRanges(ctx.getVkDevice(), 1, &range);
@@ -788,16 +1110,21 @@ void lvk::VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
                                         VkPipelineStageFlags srcStageMask,
                                         VkPipelineStageFlags dstStageMask,
                                         const VkImageSubresourceRange& subresourceRange) const {
+  VulkanBarrierBatch batch(commandBuffer);
+  transitionLayout(batch, newImageLayout, srcStageMask, dstStageMask, subresourceRange);
+  batch.flush();
+}
+
+void lvk::VulkanImage::transitionLayout(VulkanBarrierBatch& batch,
+                                        VkImageLayout newImageLayout,
+                                        VkPipelineStageFlags srcStageMask,
+                                        VkPipelineStageFlags dstStageMask,
+                                        const VkImageSubresourceRange& subresourceRange) const {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_BARRIER);
 
   VkAccessFlags srcAccessMask = 0;
   VkAccessFlags dstAccessMask = 0;
 
-  if (vkImageLayout_ == VK_IMAGE_LAYOUT_UNDEFINED) {
-    // we do not need to wait for any previous operations in this case
-    srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-  }
-
   const VkPipelineStageFlags doNotRequireAccessMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT |
                                                       VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT | VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
   VkPipelineStageFlags srcRemainingMask = srcStageMask & ~doNotRequireAccessMask;
@@ -853,10 +1180,156 @@ void lvk::VulkanImage::transitionLayout(VkCommandBuffer commandBuffer,
 
   LVK_ASSERT_MSG(dstRemainingMask == 0, "Automatic access mask deduction is not implemented (yet) for this dstStageMask");
 
-  lvk::imageMemoryBarrier(
-      commandBuffer, vkImage_, srcAccessMask, dstAccessMask, vkImageLayout_, newImageLayout, srcStageMask, dstStageMask, subresourceRange);
+  // legacy stage and access bits have the same values in synchronization2
+  transitionLayout(batch, newImageLayout, srcStageMask, srcAccessMask, dstStageMask, dstAccessMask, subresourceRange);
+}
+
+void lvk::VulkanImage::transitionLayout(VulkanBarrierBatch& batch,
+                                        VkImageLayout newImageLayout,
+                                        VkPipelineStageFlags2 srcStages,
+                                        VkAccessFlags2 srcAccess,
+                                        VkPipelineStageFlags2 dstStages,
+                                        VkAccessFlags2 dstAccess,
+                                        const VkImageSubresourceRange& range,
+                                        bool discard) const {
+  const uint32_t baseLevel = range.baseMipLevel;
+  const uint32_t baseLayer = range.baseArrayLayer;
+  const uint32_t numLevels = range.levelCount == VK_REMAINING_MIP_LEVELS ? numLevels_ - baseLevel : range.levelCount;
+  const uint32_t numLayers = range.layerCount == VK_REMAINING_ARRAY_LAYERS ? numLayers_ - baseLayer : range.layerCount;
+
+  LVK_ASSERT(baseLevel + numLevels <= numLevels_);
+  LVK_ASSERT(baseLayer + numLayers <= numLayers_);
+
+  std::vector<SubresourceState>& subresourceStates = metadata_->subresourceStates_;
+
+  if (subresourceStates.empty()) {
+    subresourceStates.resize(numLevels_ * numLayers_, SubresourceState{.layout = vkImageLayout_});
+  }
+
+  auto barrier = [&](const SubresourceState& state, uint32_t level, uint32_t levelCount, uint32_t layer, uint32_t layerCount) {
+    // A known last access is precise. Discarding drops only the contents, not the dependency: the memory may still be accessed by its
+    // previous user, for example, another texture aliasing it, which only the caller knows about.
+    const bool useCallerMasks = discard || state.stages == VK_PIPELINE_STAGE_2_NONE;
+    batch.add(VkImageMemoryBarrier2{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+        .srcStageMask = useCallerMasks ? srcStages | state.stages : state.stages,
+        .srcAccessMask = useCallerMasks ? srcAccess | state.writes : state.writes,
+        .dstStageMask = dstStages,
+        .dstAccessMask = dstAccess,
+        .oldLayout = discard ? VK_IMAGE_LAYOUT_UNDEFINED : state.layout,
+        .newLayout = newImageLayout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = vkImage_,
+        .subresourceRange = {range.aspectMask, level, levelCount, layer, layerCount},
+    });
+  };
+
+  const SubresourceState& first = subresourceStates[baseLayer * numLevels_ + baseLevel];
+
+  bool isUniform = true;
+  for (uint32_t layer = baseLayer; layer != baseLayer + numLayers && isUniform; layer++) {
+    for (uint32_t level = baseLevel; level != baseLevel + numLevels && isUniform; level++) {
+      isUniform = subresourceStates[layer * numLevels_ + level] == first;
+    }
+  }
+
+  if (isUniform) {
+    barrier(first, baseLevel, numLevels, baseLayer, numLayers);
+  } else {
+    // one barrier per run of mip-levels with identical states in every layer
+    for (uint32_t layer = baseLayer; layer != baseLayer + numLayers; layer++) {
+      const SubresourceState* states = &subresourceStates[layer * numLevels_];
+      uint32_t runStart = baseLevel;
+      for (uint32_t level = baseLevel + 1; level <= baseLevel + numLevels; level++) {
+        if (level == baseLevel + numLevels || !(states[level] == states[runStart])) {
+          barrier(states[runStart], runStart, level - runStart, layer, 1);
+          runStart = level;
+        }
+      }
+    }
+  }
+
+  // the top of the pipe does not access anything, so the next barrier falls back to the caller's stages
+  setSubresourceState(range,
+                      SubresourceState{
+                          .layout = newImageLayout,
+                          .stages = dstStages & ~VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+                          .writes = dstAccess & (VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+                                                 VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                                 VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT),
+                      });
+}
+
+void lvk::VulkanImage::setSubresourceState(const VkImageSubresourceRange& range, const SubresourceState& state) const {
+  const uint32_t baseLevel = range.baseMipLevel;
+  const uint32_t baseLayer = range.baseArrayLayer;
+  const uint32_t numLevels = range.levelCount == VK_REMAINING_MIP_LEVELS ? numLevels_ - baseLevel : range.levelCount;
+  const uint32_t numLayers = range.layerCount == VK_REMAINING_ARRAY_LAYERS ? numLayers_ - baseLayer : range.layerCount;
+
+  std::vector<SubresourceState>& subresourceStates = metadata_->subresourceStates_;
+
+  if (numLevels == numLevels_ && numLayers == numLayers_) {
+    // the whole image is in one state again
+    subresourceStates.assign(numLevels_ * numLayers_, state);
+    vkImageLayout_ = state.layout;
+    return;
+  }
+
+  if (subresourceStates.empty()) {
+    subresourceStates.resize(numLevels_ * numLayers_, SubresourceState{.layout = vkImageLayout_});
+  }
+
+  vkImageLayout_ = state.layout;
+
+  for (uint32_t layer = baseLayer; layer != baseLayer + numLayers; layer++) {
+    for (uint32_t level = baseLevel; level != baseLevel + numLevels; level++) {
+      subresourceStates[layer * numLevels_ + level] = state;
+    }
+  }
+}
+
+VkImageLayout lvk::VulkanImage::getSubresourceLayout(uint32_t level, uint32_t layer) const {
+  LVK_ASSERT(level < numLevels_ && layer < numLayers_);
+
+  const std::vector<SubresourceState>& subresourceStates = metadata_->subresourceStates_;
+
+  return subresourceStates.empty() ? vkImageLayout_ : subresourceStates[layer * numLevels_ + level].layout;
+}
+
+void lvk::VulkanBarrierBatch::add(const VkImageMemoryBarrier2& barrier) {
+  if (numImageBarriers_ == kMaxBarriers) {
+    flush();
+  }
+  imageBarriers_[numImageBarriers_++] = barrier;
+}
+
+void lvk::VulkanBarrierBatch::add(const VkBufferMemoryBarrier2& barrier) {
+  if (numBufferBarriers_ == kMaxBarriers) {
+    flush();
+  }
+  bufferBarriers_[numBufferBarriers_++] = barrier;
+}
+
+void lvk::VulkanBarrierBatch::flush() {
+  if (empty()) {
+    return;
+  }
+
+  LVK_ASSERT(cmdBuf_);
+
+  const VkDependencyInfo info = {
+      .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+      .bufferMemoryBarrierCount = numBufferBarriers_,
+      .pBufferMemoryBarriers = bufferBarriers_,
+      .imageMemoryBarrierCount = numImageBarriers_,
+      .pImageMemoryBarriers = imageBarriers_,
+  };
+
+  vkCmdPipelineBarrier2(cmdBuf_, &info);
 
-  vkImageLayout_ = newImageLayout;
+  numImageBarriers_ = 0;
+  numBufferBarriers_ = 0;
 }
 
 VkImageAspectFlags lvk::VulkanImage::getImageAspectFlags() const {
@@ -872,11 +1345,13 @@ VkImageAspectFlags lvk::VulkanImage::getImageAspectFlags() const {
 void lvk::VulkanImage::generateMipmap(VkCommandBuffer commandBuffer) const {
   LVK_PROFILER_FUNCTION();
 
+  const VkFormatFeatureFlags formatFeatures = metadata_->vkFormatProperties_.optimalTilingFeatures;
+
   // Check if device supports downscaling for color or depth/stencil buffer based on image format
   {
     const uint32_t formatFeatureMask = (VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT);
 
-    const bool hardwareDownscalingSupported = (vkFormatProperties_.optimalTilingFeatures & formatFeatureMask) == formatFeatureMask;
+    const bool hardwareDownscalingSupported = (formatFeatures & formatFeatureMask) == formatFeatureMask;
 
     if (!LVK_VERIFY(hardwareDownscalingSupported)) {
       LVK_ASSERT_MSG(false, "Doesn't support hardware downscaling of this image format: {}");
@@ -894,7 +1369,7 @@ void lvk::VulkanImage::generateMipmap(VkCommandBuffer commandBuffer) const {
       return VK_FILTER_LINEAR;
     }
     return VK_FILTER_NEAREST;
-  }(isDepthFormat_ || isStencilFormat_, vkFormatProperties_.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+  }(isDepthFormat_ || isStencilFormat_, formatFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
 
   const VkImageAspectFlags imageAspectFlags = getImageAspectFlags();
 
@@ -905,7 +1380,7 @@ void lvk::VulkanImage::generateMipmap(VkCommandBuffer commandBuffer) const {
   };
   vkCmdBeginDebugUtilsLabelEXT(commandBuffer, &utilsLabel);
 
-  const VkImageLayout originalImageLayout = vkImageLayout_;
+  const VkImageLayout originalImageLayout = getSubresourceLayout(0, 0);
 
   LVK_ASSERT(originalImageLayout != VK_IMAGE_LAYOUT_UNDEFINED);
 
@@ -993,7 +1468,12 @@ void lvk::VulkanImage::generateMipmap(VkCommandBuffer commandBuffer) const {
                           VkImageSubresourceRange{imageAspectFlags, 0, numLevels_, 0, numLayers_});
   vkCmdEndDebugUtilsLabelEXT(commandBuffer);
 
-  vkImageLayout_ = originalImageLayout;
+  setSubresourceState(VkImageSubresourceRange{imageAspectFlags, 0, numLevels_, 0, numLayers_},
+                      SubresourceState{
+                          .layout = originalImageLayout,
+                          .stages = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                          .writes = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                      });
 }
 
 bool lvk::VulkanImage::isDepthFormat(VkFormat format) {
@@ -1007,28 +1487,38 @@ bool lvk::VulkanImage::isStencilFormat(VkFormat format) {
 }
 
 VkImageView lvk::VulkanImage::getOrCreateVkImageViewForFramebuffer(VulkanContext& ctx, uint8_t level, uint16_t layer) {
-  LVK_ASSERT(level < LVK_MAX_MIP_LEVELS);
-  LVK_ASSERT(layer < LVK_ARRAY_NUM_ELEMENTS(imageViewForFramebuffer_[0]));
+  LVK_ASSERT(level < numLevels_);
+  LVK_ASSERT(layer < numLayers_);
 
-  if (level >= LVK_MAX_MIP_LEVELS || layer >= LVK_ARRAY_NUM_ELEMENTS(imageViewForFramebuffer_[0])) {
+  if (level >= numLevels_ || layer >= numLayers_) {
     return VK_NULL_HANDLE;
   }
 
-  if (imageViewForFramebuffer_[level][layer] != VK_NULL_HANDLE) {
-    return imageViewForFramebuffer_[level][layer];
+  // only a handful of views per render target, a linear search is fine
+  std::vector<VulkanImageMetadata::FramebufferView>& framebufferViews = metadata_->framebufferViews_;
+
+  for (const VulkanImageMetadata::FramebufferView& v : framebufferViews) {
+    if (v.level == level && v.layer == layer) {
+      return v.view;
+    }
   }
 
-  imageViewForFramebuffer_[level][layer] =
+  const VkImageView view =
       createImageView(ctx.getVkDevice(), VK_IMAGE_VIEW_TYPE_2D, vkImageFormat_, getImageAspectFlags(), level, 1u, layer, 1u);
 
-  return imageViewForFramebuffer_[level][layer];
+  framebufferViews.push_back({.level = level, .layer = layer, .view = view});
+
+  return view;
 }
 
 lvk::VulkanSwapchain::VulkanSwapchain(VulkanContext& ctx, uint32_t width, uint32_t height) :
   ctx_(ctx), device_(ctx.vkDevice_), graphicsQueue_(ctx.deviceQueues_.graphicsQueue), width_(width), height_(height) {
-  surfaceFormat_ = chooseSwapSurfaceFormat(ctx.deviceSurfaceFormats_, ctx.config_.swapChainColorSpace);
+  if (ctx.isHeadless_) {
+    createVirtualImages();
+    return;
+  }
 
-  acquireSemaphore_ = lvk::createSemaphore(device_, "Semaphore: swapchain-acquire");
+  surfaceFormat_ = chooseSwapSurfaceFormat(ctx.deviceSurfaceFormats_, ctx.config_.swapChainColorSpace);
 
   LVK_ASSERT_MSG(ctx.vkSurface_ != VK_NULL_HANDLE,
                  "You are trying to create a swapchain but your OS surface is empty. Did you want to "
@@ -1046,14 +1536,33 @@ lvk::VulkanSwapchain::VulkanSwapchain(VulkanContext& ctx, uint32_t width, uint32
     return exceeded ? caps.maxImageCount : desired;
   };
 
-  auto chooseSwapPresentMode = [](const std::vector<VkPresentModeKHR>& modes) -> VkPresentModeKHR {
+  auto chooseSwapPresentMode = [](const std::vector<VkPresentModeKHR>& modes, lvk::PresentMode mode) -> VkPresentModeKHR {
+    auto isSupported = [&modes](VkPresentModeKHR m) { return std::find(modes.cbegin(), modes.cend(), m) != modes.cend(); };
+    switch (mode) {
+    case PresentMode_Auto:
 #if defined(__linux__)
-    if (std::find(modes.cbegin(), modes.cend(), VK_PRESENT_MODE_IMMEDIATE_KHR) != modes.cend()) {
-      return VK_PRESENT_MODE_IMMEDIATE_KHR;
-    }
+      if (isSupported(VK_PRESENT_MODE_IMMEDIATE_KHR)) {
+        return VK_PRESENT_MODE_IMMEDIATE_KHR;
+      }
 #endif // __linux__
-    if (std::find(modes.cbegin(), modes.cend(), VK_PRESENT_MODE_MAILBOX_KHR) != modes.cend()) {
-      return VK_PRESENT_MODE_MAILBOX_KHR;
+      if (isSupported(VK_PRESENT_MODE_MAILBOX_KHR)) {
+        return VK_PRESENT_MODE_MAILBOX_KHR;
+      }
+      break;
+    case PresentMode_Fifo:
+      break;
+    case PresentMode_Mailbox:
+      if (isSupported(VK_PRESENT_MODE_MAILBOX_KHR)) {
+        return VK_PRESENT_MODE_MAILBOX_KHR;
+      }
+      LLOGW("VK_PRESENT_MODE_MAILBOX_KHR is not supported, falling back to VK_PRESENT_MODE_FIFO_KHR\n");
+      break;
+    case PresentMode_Immediate:
+      if (isSupported(VK_PRESENT_MODE_IMMEDIATE_KHR)) {
+        return VK_PRESENT_MODE_IMMEDIATE_KHR;
+      }
+      LLOGW("VK_PRESENT_MODE_IMMEDIATE_KHR is not supported, falling back to VK_PRESENT_MODE_FIFO_KHR\n");
+      break;
     }
     return VK_PRESENT_MODE_FIFO_KHR;
   };
@@ -1097,7 +1606,7 @@ lvk::VulkanSwapchain::VulkanSwapchain(VulkanContext& ctx, uint32_t width, uint32
     .preTransform = ctx.deviceSurfaceCaps_.currentTransform,
 #endif
     .compositeAlpha = isCompositeAlphaOpaqueSupported ? VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR : VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR,
-    .presentMode = chooseSwapPresentMode(ctx.devicePresentModes_),
+    .presentMode = chooseSwapPresentMode(ctx.devicePresentModes_, ctx.config_.presentMode),
     .clipped = VK_TRUE,
     .oldSwapchain = VK_NULL_HANDLE,
   };
@@ -1115,9 +1624,13 @@ lvk::VulkanSwapchain::VulkanSwapchain(VulkanContext& ctx, uint32_t width, uint32
 
   char debugNameImage[256] = {0};
   char debugNameImageView[256] = {0};
+  char debugNameSemaphore[256] = {0};
 
   // create images, image views and framebuffers
   for (uint32_t i = 0; i < numSwapchainImages_; i++) {
+    snprintf(debugNameSemaphore, sizeof(debugNameSemaphore) - 1, "Semaphore: swapchain-acquire %u", i);
+    acquireSemaphores_[i] = lvk::createSemaphore(device_, debugNameSemaphore);
+
     snprintf(debugNameImage, sizeof(debugNameImage) - 1, "Image: swapchain %u", i);
     snprintf(debugNameImageView, sizeof(debugNameImageView) - 1, "Image View: swapchain %u", i);
     VulkanImage image = {
@@ -1144,20 +1657,78 @@ lvk::VulkanSwapchain::VulkanSwapchain(VulkanContext& ctx, uint32_t width, uint32
                                              {},
                                              debugNameImageView);
 
+    std::lock_guard lock(ctx_.pimpl_->resourcesMutex_);
     swapchainTextures_[i] = ctx_.texturesPool_.create(std::move(image));
+    ctx_.texturesPool_.get(swapchainTextures_[i])->metadata_ = ctx_.texturesPool_.getCold(swapchainTextures_[i]);
+  }
+}
+
+void lvk::VulkanSwapchain::createVirtualImages() {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+
+  isVirtual_ = true;
+  numSwapchainImages_ = std::clamp(ctx_.config_.numVirtualSwapchainImages, 1u, (uint32_t)LVK_MAX_SWAPCHAIN_IMAGES);
+
+  // the RGBA formats chooseSwapSurfaceFormat() would pick; 8-bit UNORM images support storage on every device
+  const bool isLinear = ctx_.config_.swapChainColorSpace == ColorSpace_SRGB_LINEAR;
+  const lvk::Format format = isLinear ? Format_RGBA_UN8 : Format_RGBA_SRGB8;
+
+  surfaceFormat_ = {
+      .format = formatToVkFormat(format),
+      .colorSpace = isLinear ? VK_COLOR_SPACE_BT709_LINEAR_EXT : VK_COLOR_SPACE_SRGB_NONLINEAR_KHR,
+  };
+
+  char debugName[256] = {0};
+
+  for (uint32_t i = 0; i != numSwapchainImages_; i++) {
+    snprintf(debugName, sizeof(debugName) - 1, "Image: virtual swapchain %u", i);
+    Holder<TextureHandle> texture = ctx_.createTexture(
+        {
+            .format = format,
+            .dimensions = {width_, height_},
+            .usage = uint8_t(TextureUsageBits_Attachment | TextureUsageBits_Sampled | (isLinear ? TextureUsageBits_Storage : 0)),
+        },
+        debugName,
+        nullptr);
+    LVK_ASSERT(texture.valid());
+    {
+      // behave like real swapchain images, for example, destroy(Framebuffer&) must skip them
+      std::lock_guard lock(ctx_.pimpl_->resourcesMutex_);
+      ctx_.texturesPool_.get(texture)->isSwapchainImage_ = true;
+    }
+    swapchainTextures_[i] = texture.release();
+
+    if (ctx_.config_.readbackVirtualSwapchain) {
+      snprintf(debugName, sizeof(debugName) - 1, "Buffer: virtual swapchain readback %u", i);
+      readbackBuffers_[i] = ctx_.createBuffer(VkDeviceSize(width_) * height_ * 4u,
+                                              VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                              nullptr,
+                                              debugName);
+      LVK_ASSERT(readbackBuffers_[i].valid());
+    }
   }
 }
 
 lvk::VulkanSwapchain::~VulkanSwapchain() {
   for (TextureHandle handle : swapchainTextures_) {
+    if (isVirtual_ && handle) {
+      // virtual swapchain images own their memory
+      std::lock_guard lock(ctx_.pimpl_->resourcesMutex_);
+      ctx_.texturesPool_.get(handle)->isSwapchainImage_ = false;
+    }
+    ctx_.destroy(handle);
+  }
+  for (BufferHandle handle : readbackBuffers_) {
     ctx_.destroy(handle);
   }
-  if (acquireFence_ != VK_NULL_HANDLE) {
-    vkWaitForFences(device_, 1, &acquireFence_, VK_TRUE, UINT64_MAX);
-    vkDestroyFence(device_, acquireFence_, nullptr);
+  // the entry point is not loaded when VK_KHR_swapchain is not enabled
+  if (swapchain_ != VK_NULL_HANDLE) {
+    vkDestroySwapchainKHR(device_, swapchain_, nullptr);
+  }
+  for (VkSemaphore semaphore : acquireSemaphores_) {
+    vkDestroySemaphore(device_, semaphore, nullptr);
   }
-  vkDestroySwapchainKHR(device_, swapchain_, nullptr);
-  vkDestroySemaphore(device_, acquireSemaphore_, nullptr);
 }
 
 VkImage lvk::VulkanSwapchain::getCurrentVkImage() const {
@@ -1179,24 +1750,27 @@ VkImageView lvk::VulkanSwapchain::getCurrentVkImageView() const {
 lvk::TextureHandle lvk::VulkanSwapchain::getCurrentTexture() {
   LVK_PROFILER_FUNCTION();
 
+  if (getNextImage_ && isVirtual_) {
+    // images are used round-robin; the GPU work of the previous frame which used this image is ordered by its layout transitions
+    currentImageIndex_ = uint32_t(lastPresentId_ % numSwapchainImages_);
+    getNextImage_ = false;
+  }
+
   if (getNextImage_) {
-    // Our first submit handle can be still waiting on the previous `acquireSemaphore`.
-    //   vkAcquireNextImageKHR():  Semaphore must not have any pending operations. The Vulkan spec states:
-    //   If semaphore is not VK_NULL_HANDLE it must not have any uncompleted signal or wait operations pending
+    // vkAcquireNextImageKHR(): the semaphore must not have any uncompleted signal or wait operations pending
     //   (https://vulkan.lunarg.com/doc/view/1.3.275.0/windows/1.3-extensions/vkspec.html#VUID-vkAcquireNextImageKHR-semaphore-01779)
-    if (acquireFence_ == VK_NULL_HANDLE) {
-      acquireFence_ = lvk::createFence(device_, "Fence: swapchain-acquire");
-    } else {
-      vkWaitForFences(device_, 1, &acquireFence_, VK_TRUE, UINT64_MAX);
-      vkResetFences(device_, 1, &acquireFence_);
-    }
+    // The semaphore was last waited on by a submit `numSwapchainImages_` presents ago, which has normally finished by now, so this
+    // does not block the CPU on the presentation engine.
+    acquireSemaphoreIndex_ = (acquireSemaphoreIndex_ + 1) % numSwapchainImages_;
+    ctx_.immediate_->wait(acquireSubmitHandles_[acquireSemaphoreIndex_]);
+    const VkSemaphore acquireSemaphore = acquireSemaphores_[acquireSemaphoreIndex_];
     // when timeout is set to UINT64_MAX, we wait until the next image has been acquired
-    VkResult r = vkAcquireNextImageKHR(device_, swapchain_, UINT64_MAX, acquireSemaphore_, acquireFence_, &currentImageIndex_);
+    VkResult r = vkAcquireNextImageKHR(device_, swapchain_, UINT64_MAX, acquireSemaphore, VK_NULL_HANDLE, &currentImageIndex_);
     if (r != VK_SUCCESS && r != VK_SUBOPTIMAL_KHR && r != VK_ERROR_OUT_OF_DATE_KHR) {
       VK_ASSERT(r);
     }
     getNextImage_ = false;
-    ctx_.immediate_->waitSemaphore(acquireSemaphore_);
+    ctx_.immediate_->waitSemaphore(acquireSemaphore);
   }
 
   if (LVK_VERIFY(currentImageIndex_ < numSwapchainImages_)) {
@@ -1217,9 +1791,32 @@ uint32_t lvk::VulkanSwapchain::getNumSwapchainImages() const {
 lvk::Result lvk::VulkanSwapchain::present(VkSemaphore waitSemaphore) {
   LVK_PROFILER_FUNCTION();
 
+  if (isVirtual_) {
+    // nothing is shown: the image is done once the submit which presented it has finished
+    lastPresentId_++;
+    presentSubmitHandles_[currentImageIndex_] = ctx_.immediate_->getLastSubmitHandle();
+    if (readbackBuffers_[currentImageIndex_]) {
+      readbackPresentIds_[currentImageIndex_] = lastPresentId_;
+    }
+    getNextImage_ = true;
+    LVK_PROFILER_FRAME(nullptr);
+    return Result();
+  }
+
+  // the submit which is being presented is the last one to wait on the current acquire semaphore
+  acquireSubmitHandles_[acquireSemaphoreIndex_] = ctx_.immediate_->getLastSubmitHandle();
+
+  const uint64_t presentId = lastPresentId_ + 1;
+  const VkPresentIdKHR presentIdInfo = {
+      .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+      .swapchainCount = 1u,
+      .pPresentIds = &presentId,
+  };
+
   LVK_PROFILER_ZONE("vkQueuePresent()", LVK_PROFILER_COLOR_PRESENT);
   const VkPresentInfoKHR pi = {
       .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+      .pNext = ctx_.hasPresentWait_ ? &presentIdInfo : nullptr,
       .waitSemaphoreCount = 1,
       .pWaitSemaphores = &waitSemaphore,
       .swapchainCount = 1u,
@@ -1232,6 +1829,10 @@ lvk::Result lvk::VulkanSwapchain::present(VkSemaphore waitSemaphore) {
   }
   LVK_PROFILER_ZONE_END();
 
+  if (ctx_.hasPresentWait_) {
+    lastPresentId_ = presentId;
+  }
+
   // Ready to call acquireNextImage() on the next getCurrentVulkanTexture();
   getNextImage_ = true;
 
@@ -1240,6 +1841,97 @@ lvk::Result lvk::VulkanSwapchain::present(VkSemaphore waitSemaphore) {
   return Result();
 }
 
+bool lvk::VulkanSwapchain::waitForPresent(uint64_t presentId, uint64_t timeoutNanoseconds) const {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_WAIT);
+
+  if (isVirtual_) {
+    if (presentId > lastPresentId_) {
+      return false;
+    }
+    // the image has been presented again since then, so its older submit is complete
+    if (lastPresentId_ - presentId >= numSwapchainImages_) {
+      return true;
+    }
+    // the timeout is not used: waiting for a submit is bounded by the GPU work itself
+    ctx_.immediate_->wait(presentSubmitHandles_[(presentId - 1) % numSwapchainImages_]);
+    return true;
+  }
+
+  const VkResult r = vkWaitForPresentKHR(device_, swapchain_, presentId, timeoutNanoseconds);
+
+  return r == VK_SUCCESS || r == VK_SUBOPTIMAL_KHR;
+}
+
+void lvk::VulkanSwapchain::recordReadback(VkCommandBuffer cmdBuf, VulkanBarrierBatch& barriers, const VulkanImage& image) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT(isVirtual_);
+
+  const BufferHandle handle = readbackBuffers_[currentImageIndex_];
+
+  if (!handle) {
+    return;
+  }
+
+  const lvk::VulkanBuffer* buf = ctx_.buffersPool_.get(handle);
+
+  // the layout transition to VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL has been flushed by the caller
+  const VkBufferImageCopy copy = {
+      .bufferOffset = 0,
+      .bufferRowLength = 0,
+      .bufferImageHeight = 0,
+      .imageSubresource = VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+      .imageOffset = {},
+      .imageExtent = image.vkExtent_,
+  };
+  vkCmdCopyImageToBuffer(cmdBuf, image.vkImage_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buf->vkBuffer_, 1, &copy);
+
+  // make the copy visible to the host once the submit has finished
+  barriers.add(VkBufferMemoryBarrier2{
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+      .srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+      .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+      .dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT,
+      .dstAccessMask = VK_ACCESS_2_HOST_READ_BIT,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .buffer = buf->vkBuffer_,
+      .offset = 0,
+      .size = VK_WHOLE_SIZE,
+  });
+}
+
+uint64_t lvk::VulkanSwapchain::readbackPresentedImage(void* outData, size_t sizeInBytes) {
+  LVK_PROFILER_FUNCTION();
+
+  // the oldest frame which has not been read yet
+  uint32_t slot = numSwapchainImages_;
+
+  for (uint32_t i = 0; i != numSwapchainImages_; i++) {
+    const uint64_t id = readbackPresentIds_[i];
+    if (id > lastReadbackPresentId_ && (slot == numSwapchainImages_ || id < readbackPresentIds_[slot])) {
+      slot = i;
+    }
+  }
+
+  // submits finish in order, so if the oldest frame is not ready, no newer one is
+  if (slot == numSwapchainImages_ || !ctx_.immediate_->isReady(presentSubmitHandles_[slot])) {
+    return 0;
+  }
+
+  const lvk::VulkanBuffer* buf = ctx_.buffersPool_.get(readbackBuffers_[slot]);
+
+  if (!buf->isCoherentMemory_) {
+    buf->invalidateMappedMemory(ctx_, 0, VK_WHOLE_SIZE);
+  }
+
+  memcpy(outData, buf->getMappedPtr(), std::min(sizeInBytes, (size_t)buf->bufferSize_));
+
+  lastReadbackPresentId_ = readbackPresentIds_[slot];
+
+  return lastReadbackPresentId_;
+}
+
 lvk::VulkanImmediateCommands::VulkanImmediateCommands(VkDevice device, uint32_t queueFamilyIndex, const char* debugName) :
   device_(device), queueFamilyIndex_(queueFamilyIndex), debugName_(debugName) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
@@ -1763,7 +2455,13 @@ VkResult lvk::VulkanPipelineBuilder::build(VkDevice device,
   return lvk::setDebugObjectName(device, VK_OBJECT_TYPE_PIPELINE, (uint64_t)*outPipeline, debugName);
 }
 
-lvk::CommandBuffer::CommandBuffer(VulkanContext* ctx) : ctx_(ctx), wrapper_(&ctx_->immediate_->acquire()) {}
+lvk::CommandBuffer::CommandBuffer(VulkanContext* ctx) : ctx_(ctx), wrapper_(&ctx_->immediate_->acquire()), barriers_(wrapper_->cmdBuf_) {}
+
+lvk::CommandBuffer::CommandBuffer(VulkanContext* ctx, CommandBundleState* bundle) :
+  ctx_(ctx), wrapper_(&bundle->wrapper_), bundle_(bundle), barriers_(wrapper_->cmdBuf_) {
+  // a bundle is always recorded inside a render pass
+  isRendering_ = true;
+}
 
 lvk::CommandBuffer::~CommandBuffer() {
   // did you forget to call cmdEndRendering()?
@@ -1782,14 +2480,16 @@ void lvk::CommandBuffer::transitionToShaderReadOnly(TextureHandle handle) const
     const VkImageAspectFlags flags = img.getImageAspectFlags();
     VkPipelineStageFlags srcStage = 0;
     if (img.isSampledImage()) {
-      srcStage |= isDepthOrStencilVkFormat(img.vkImageFormat_) ? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
-                                                               : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+      // depth resolves are performed in the color attachment output stage
+      srcStage |= isDepthOrStencilVkFormat(img.vkImageFormat_)
+                      ? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+                      : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     }
     if (img.isStorageImage()) {
       srcStage |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
     }
     // set the result of the previous render pass
-    img.transitionLayout(wrapper_->cmdBuf_,
+    img.transitionLayout(barriers_,
                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                          srcStage,
                          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // wait for subsequent
@@ -1820,29 +2520,252 @@ void lvk::CommandBuffer::cmdBindComputePipeline(lvk::ComputePipelineHandle handl
     vkCmdBindPipeline(wrapper_->cmdBuf_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
     ctx_->checkAndUpdateDescriptorSets();
     ctx_->bindDefaultDescriptorSets(wrapper_->cmdBuf_, VK_PIPELINE_BIND_POINT_COMPUTE, cps->pipelineLayout_);
+    onPipelineLayoutBound(cps->pipelineLayout_);
+  } else {
+    stats_.skippedPipelineBinds++;
   }
 }
 
-void lvk::CommandBuffer::cmdDispatchThreadGroups(const Dimensions& threadgroupCount, const Dependencies& deps) {
-  LVK_PROFILER_FUNCTION();
+void lvk::CommandBuffer::resetRenderingState() {
+  // start every render pass from a known state
+  state_ = {};
 
-  LVK_ASSERT(!isRendering_);
+  cmdBindDepthState({});
+
+  vkCmdSetDepthCompareOp(wrapper_->cmdBuf_, VK_COMPARE_OP_ALWAYS);
+  vkCmdSetDepthBiasEnable(wrapper_->cmdBuf_, VK_FALSE);
+  state_.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+  state_.depthBiasEnable = VK_FALSE;
+  state_.hasDepthBiasEnable = true;
+}
+
+void lvk::CommandBuffer::onPipelineLayoutBound(VkPipelineLayout layout) {
+  if (lastPipelineLayoutBound_ != layout) {
+    lastPipelineLayoutBound_ = layout;
+    // push constants are not guaranteed to survive a switch to an incompatible pipeline layout
+    state_.pushConstantsLayout = VK_NULL_HANDLE;
+  }
+}
 
+void lvk::CommandBuffer::useComputeDependencies(const Dependencies& deps) {
   for (uint32_t i = 0; i != Dependencies::LVK_MAX_SUBMIT_DEPENDENCIES && deps.textures[i]; i++) {
     useComputeTexture(deps.textures[i]);
   }
   for (uint32_t i = 0; i != Dependencies::LVK_MAX_SUBMIT_DEPENDENCIES && deps.buffers[i]; i++) {
-    bufferBarrier(
-        deps.buffers[i], VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    VkPipelineStageFlags2 unknownStages =
+        VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    const lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(deps.buffers[i]);
+    LVK_ASSERT(buf);
+    if (buf->vkUsageFlags_ & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) {
+      unknownStages |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+    }
+    useBufferRange(deps.buffers[i],
+                   deps.bufferOffsets[i],
+                   deps.bufferSizes[i],
+                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+                   true,
+                   unknownStages,
+                   VK_ACCESS_2_SHADER_WRITE_BIT);
   }
-
-  vkCmdDispatch(wrapper_->cmdBuf_, threadgroupCount.width, threadgroupCount.height, threadgroupCount.depth);
 }
 
-void lvk::CommandBuffer::cmdPushDebugGroupLabel(const char* label, uint32_t colorRGBA) const {
-  LVK_ASSERT(label);
+void lvk::CommandBuffer::cmdDispatchThreadGroups(const Dimensions& threadgroupCount, const Dependencies& deps) {
+  LVK_PROFILER_FUNCTION();
 
-  if (!label) {
+  LVK_ASSERT(!isRendering_);
+
+  useComputeDependencies(deps);
+  flushBarriers();
+
+  vkCmdDispatch(wrapper_->cmdBuf_, threadgroupCount.width, threadgroupCount.height, threadgroupCount.depth);
+
+  invalidateBufferVisibility();
+}
+
+void lvk::CommandBuffer::cmdDispatchThreadGroupsIndirect(BufferHandle indirectBuffer,
+                                                         size_t indirectBufferOffset,
+                                                         const Dependencies& deps) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT(!isRendering_);
+
+  const lvk::VulkanBuffer* bufIndirect = ctx_->buffersPool_.get(indirectBuffer);
+
+  if (!LVK_VERIFY(bufIndirect)) {
+    return;
+  }
+
+  LVK_ASSERT(bufIndirect->vkUsageFlags_ & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+  LVK_ASSERT(indirectBufferOffset % 4 == 0);
+  LVK_ASSERT(indirectBufferOffset + sizeof(VkDispatchIndirectCommand) <= bufIndirect->bufferSize_);
+
+  // the dispatch size is fetched in the DRAW_INDIRECT stage, which is not covered by the compute dependencies
+  useBufferRange(indirectBuffer,
+                 indirectBufferOffset,
+                 sizeof(VkDispatchIndirectCommand),
+                 VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                 VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+                 false,
+                 VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                 VK_ACCESS_2_SHADER_WRITE_BIT);
+  useComputeDependencies(deps);
+  flushBarriers();
+
+  vkCmdDispatchIndirect(wrapper_->cmdBuf_, bufIndirect->vkBuffer_, bufIndirect->bufferOffset_ + indirectBufferOffset);
+
+  invalidateBufferVisibility();
+}
+
+void lvk::CommandBuffer::cmdPipelineBarrier(const BufferBarrier* bufferBarriers,
+                                            uint32_t numBufferBarriers,
+                                            const TextureBarrier* textureBarriers,
+                                            uint32_t numTextureBarriers) {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_BARRIER);
+
+  LVK_ASSERT(!isRendering_);
+  LVK_ASSERT(bufferBarriers || !numBufferBarriers);
+  LVK_ASSERT(textureBarriers || !numTextureBarriers);
+
+  // merged with the automatic barriers and recorded before the next draw, dispatch or copy
+  VulkanBarrierBatch& batch = barriers_;
+
+  for (uint32_t i = 0; i != numBufferBarriers; i++) {
+    const BufferBarrier& barrier = bufferBarriers[i];
+    const lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(barrier.buffer);
+    if (!LVK_VERIFY(buf)) {
+      continue;
+    }
+    // explicit barriers are not tracked, so the next automatic barrier for this buffer is conservative again
+    forgetBufferRange(barrier.buffer);
+    batch.add(VkBufferMemoryBarrier2{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+        .srcStageMask = resourceAccessToVkPipelineStageFlags2(barrier.before),
+        // only writes have to be made available
+        .srcAccessMask = resourceAccessToVkAccessFlags2(barrier.before & kResourceAccessWriteBits),
+        .dstStageMask = resourceAccessToVkPipelineStageFlags2(barrier.after),
+        .dstAccessMask = resourceAccessToVkAccessFlags2(barrier.after),
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = buf->vkBuffer_,
+        .offset = buf->bufferOffset_,
+        .size = buf->isSuballocated() ? buf->bufferSize_ : VK_WHOLE_SIZE,
+    });
+  }
+
+  for (uint32_t i = 0; i != numTextureBarriers; i++) {
+    const TextureBarrier& barrier = textureBarriers[i];
+    const lvk::VulkanImage* img = ctx_->texturesPool_.get(barrier.texture);
+    if (!LVK_VERIFY(img)) {
+      continue;
+    }
+    VkImageLayout newLayout = resourceAccessToVkImageLayout(barrier.after, img->isSampledImage());
+    if (newLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
+      newLayout = img->getSubresourceLayout(0, 0);
+    }
+    if (newLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
+      // a texture which has never been used cannot stay in the undefined layout after a barrier
+      newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    }
+    // tracked subresources wait only for their own last access; `before` covers the untracked ones and discards of aliased memory
+    img->transitionLayout(batch,
+                          newLayout,
+                          resourceAccessToVkPipelineStageFlags2(barrier.before),
+                          resourceAccessToVkAccessFlags2(barrier.before & kResourceAccessWriteBits),
+                          resourceAccessToVkPipelineStageFlags2(barrier.after),
+                          resourceAccessToVkAccessFlags2(barrier.after),
+                          VkImageSubresourceRange{img->getImageAspectFlags(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS},
+                          barrier.discard);
+  }
+}
+
+void lvk::CommandBuffer::cmdAliasTexture(TextureHandle from, TextureHandle to) {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_BARRIER);
+
+  LVK_ASSERT(!isRendering_);
+
+  const lvk::VulkanImage* prev = ctx_->texturesPool_.get(from);
+  const lvk::VulkanImage* next = ctx_->texturesPool_.get(to);
+
+  if (!LVK_VERIFY(prev && next)) {
+    return;
+  }
+
+  LVK_ASSERT_MSG(ctx_->texturesPool_.getCold(from)->aliasedMemory_ &&
+                     ctx_->texturesPool_.getCold(from)->aliasedMemory_ == ctx_->texturesPool_.getCold(to)->aliasedMemory_,
+                 "Only textures created by the same createAliasedTextures() call share memory");
+
+  // the last accesses to every subresource of both textures; subresources with a layout but no tracked access are waited for entirely
+  VulkanImage::SubresourceState last = {.layout = VK_IMAGE_LAYOUT_UNDEFINED};
+
+  auto addLastAccess = [&last](const VulkanImage& img) {
+    auto add = [&last](const VulkanImage::SubresourceState& s) {
+      const bool isUntracked = s.layout != VK_IMAGE_LAYOUT_UNDEFINED && !s.stages;
+      last.stages |= isUntracked ? VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT : s.stages;
+      last.writes |= isUntracked ? VK_ACCESS_2_MEMORY_WRITE_BIT : s.writes;
+    };
+    if (img.metadata_->subresourceStates_.empty()) {
+      add({.layout = img.vkImageLayout_});
+    }
+    for (const VulkanImage::SubresourceState& s : img.metadata_->subresourceStates_) {
+      add(s);
+    }
+  };
+  addLastAccess(*prev);
+  addLastAccess(*next);
+
+  // no barrier is recorded here: the undefined layout turns the next transition of `to` into a discard which waits for `last`
+  next->setSubresourceState(VkImageSubresourceRange{next->getImageAspectFlags(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS},
+                            last);
+}
+
+void lvk::CommandBuffer::setAutomaticBarriers(bool enabled) {
+  automaticBarriers_ = enabled;
+}
+
+void lvk::CommandBuffer::cmdFillBuffer(BufferHandle buffer, size_t bufferOffset, size_t size, uint32_t data) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT(!isRendering_);
+  LVK_ASSERT(size && size % 4 == 0);
+  LVK_ASSERT(bufferOffset % 4 == 0);
+
+  lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(buffer);
+
+  if (!LVK_VERIFY(buf)) {
+    return;
+  }
+
+  LVK_ASSERT(bufferOffset + size <= buf->bufferSize_);
+
+  // wait for previous readers and writers of this range
+  useBufferRange(buffer,
+                 bufferOffset,
+                 size,
+                 VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                 VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                 true,
+                 VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                 VK_ACCESS_2_MEMORY_WRITE_BIT);
+  flushBarriers();
+
+  vkCmdFillBuffer(wrapper_->cmdBuf_, buf->vkBuffer_, buf->bufferOffset_ + bufferOffset, size, data);
+
+  // make the new contents visible to everything, including commands without dependencies; merged with the barriers of the next command
+  useBufferRange(buffer,
+                 bufferOffset,
+                 size,
+                 VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                 VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+                 false,
+                 VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                 VK_ACCESS_2_MEMORY_WRITE_BIT);
+}
+
+void lvk::CommandBuffer::cmdPushDebugGroupLabel(const char* label, uint32_t colorRGBA) const {
+  LVK_ASSERT(label);
+
+  if (!label) {
     return;
   }
   const VkDebugUtilsLabelEXT utilsLabel = {
@@ -1890,98 +2813,278 @@ void lvk::CommandBuffer::useComputeTexture(TextureHandle handle) {
     return;
   }
 
-  // "frame graph" heuristics: if we are already in VK_IMAGE_LAYOUT_GENERAL, wait for the previous compute shader
+  // "frame graph" heuristics for subresources with an unknown last access: if we are already in VK_IMAGE_LAYOUT_GENERAL, wait for the
+  // previous compute shader
   const VkPipelineStageFlags srcStage = (tex.vkImageLayout_ == VK_IMAGE_LAYOUT_GENERAL) ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
                                                                                         : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-  tex.transitionLayout(wrapper_->cmdBuf_,
+  tex.transitionLayout(barriers_,
                        VK_IMAGE_LAYOUT_GENERAL,
                        srcStage,
                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                        VkImageSubresourceRange{tex.getImageAspectFlags(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
 }
 
-void lvk::CommandBuffer::bufferBarrier(BufferHandle handle, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage) {
+void lvk::CommandBuffer::useBufferRange(BufferHandle handle,
+                                        size_t offset,
+                                        size_t size,
+                                        VkPipelineStageFlags2 stages,
+                                        VkAccessFlags2 access,
+                                        bool isWrite,
+                                        VkPipelineStageFlags2 unknownStages,
+                                        VkAccessFlags2 unknownWrites) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_BARRIER);
 
-  lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(handle);
+  const lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(handle);
 
-  VkBufferMemoryBarrier barrier = {
-      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-      .srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
-      .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
-      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-      .buffer = buf->vkBuffer_,
-      .offset = 0,
-      .size = VK_WHOLE_SIZE,
+  if (!LVK_VERIFY(buf)) {
+    return;
+  }
+
+  LVK_ASSERT(offset < buf->bufferSize_);
+
+  if (!size) {
+    size = buf->bufferSize_ - offset;
+  }
+
+  LVK_ASSERT(offset + size <= buf->bufferSize_);
+
+  const uint64_t vkBuffer = (uint64_t)buf->vkBuffer_;
+  const VkDeviceSize begin = buf->bufferOffset_ + offset;
+  const VkDeviceSize end = begin + size;
+
+  // all ranges of this buffer which overlap [begin, end)
+  const auto first = std::lower_bound(
+      bufferStates_.begin(), bufferStates_.end(), std::make_pair(vkBuffer, begin), [](const BufferRangeState& s, const auto& key) {
+        return s.buffer < key.first || (s.buffer == key.first && s.end <= key.second);
+      });
+  auto last = first;
+  while (last != bufferStates_.end() && last->buffer == vkBuffer && last->begin < end) {
+    last++;
+  }
+
+  // gaps between tracked ranges were not accessed by this command buffer yet
+  const BufferRangeState unknown = {
+      .buffer = vkBuffer,
+      .writeStages = unknownStages,
+      .writeAccess = unknownWrites,
+  };
+
+  VkPipelineStageFlags2 srcStages = VK_PIPELINE_STAGE_2_NONE;
+  VkAccessFlags2 srcAccess = VK_ACCESS_2_NONE;
+
+  auto hazard = [&](const BufferRangeState& s) {
+    const bool isVisible = (s.visibleStages & VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT) || !(stages & ~s.visibleStages);
+    // read-after-write and write-after-write; reads which already see the last write need nothing until the next dispatch or render pass
+    if (s.writeStages && (isWrite || !isVisible)) {
+      srcStages |= s.writeStages;
+      srcAccess |= s.writeAccess;
+    }
+    // undeclared writes are covered by the same fallback as the ranges which were not accessed yet
+    if (s.hasUntrackedWrites && (isWrite || !isVisible)) {
+      srcStages |= unknownStages;
+      srcAccess |= unknownWrites;
+    }
+    // write-after-read needs only an execution dependency
+    if (isWrite) {
+      srcStages |= s.readStages;
+    }
   };
 
-  if (dstStage & VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT) {
-    barrier.dstAccessMask |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+  // split the overlapping ranges at `begin` and `end`, fill the gaps and apply this access
+  std::vector<BufferRangeState>& ranges = bufferStatesScratch_;
+  ranges.clear();
+
+  auto push = [&ranges](BufferRangeState s, VkDeviceSize from, VkDeviceSize to) {
+    s.begin = from;
+    s.end = to;
+    if (!ranges.empty()) {
+      BufferRangeState& prev = ranges.back();
+      if (prev.end == from && prev.writeStages == s.writeStages && prev.writeAccess == s.writeAccess &&
+          prev.visibleStages == s.visibleStages && prev.readStages == s.readStages && prev.hasUntrackedWrites == s.hasUntrackedWrites) {
+        prev.end = to;
+        return;
+      }
+    }
+    ranges.push_back(s);
+  };
+  auto apply = [&](BufferRangeState s, VkDeviceSize from, VkDeviceSize to) {
+    hazard(s);
+    if (isWrite) {
+      s.writeStages = stages;
+      s.writeAccess = access & (VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT |
+                                VK_ACCESS_2_MEMORY_WRITE_BIT);
+      s.visibleStages = VK_PIPELINE_STAGE_2_NONE;
+      s.readStages = VK_PIPELINE_STAGE_2_NONE;
+      s.hasUntrackedWrites = false;
+    } else {
+      s.visibleStages |= stages;
+      s.readStages |= stages;
+    }
+    push(s, from, to);
+  };
+
+  VkDeviceSize cursor = begin;
+
+  for (auto it = first; it != last; it++) {
+    if (it->begin < begin) {
+      push(*it, it->begin, begin);
+    }
+    if (it->begin > cursor) {
+      apply(unknown, cursor, it->begin);
+    }
+    cursor = std::min(it->end, end);
+    apply(*it, std::max(it->begin, begin), cursor);
+    if (it->end > end) {
+      push(*it, end, it->end);
+    }
+  }
+  if (cursor < end) {
+    apply(unknown, cursor, end);
   }
-  if (buf->vkUsageFlags_ & VK_BUFFER_USAGE_INDEX_BUFFER_BIT) {
-    barrier.dstAccessMask |= VK_ACCESS_INDEX_READ_BIT;
+
+  const size_t index = first - bufferStates_.begin();
+  bufferStates_.erase(first, last);
+  bufferStates_.insert(bufferStates_.begin() + index, ranges.begin(), ranges.end());
+
+  if (srcStages == VK_PIPELINE_STAGE_2_NONE) {
+    return;
   }
 
-  vkCmdPipelineBarrier(wrapper_->cmdBuf_, srcStage, dstStage, VkDependencyFlags{}, 0, nullptr, 1, &barrier, 0, nullptr);
+  barriers_.add(VkBufferMemoryBarrier2{
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+      .srcStageMask = srcStages,
+      .srcAccessMask = srcAccess,
+      .dstStageMask = stages,
+      .dstAccessMask = access,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .buffer = buf->vkBuffer_,
+      .offset = begin,
+      .size = size,
+  });
 }
 
-void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, const lvk::Framebuffer& fb, const Dependencies& deps) {
-  LVK_PROFILER_FUNCTION();
+void lvk::CommandBuffer::forgetBufferRange(BufferHandle handle) {
+  const lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(handle);
 
-  LVK_ASSERT(!isRendering_);
+  if (!buf) {
+    return;
+  }
 
-  isRendering_ = true;
+  const uint64_t vkBuffer = (uint64_t)buf->vkBuffer_;
+  const VkDeviceSize begin = buf->bufferOffset_;
+  const VkDeviceSize end = begin + buf->bufferSize_;
 
+  std::erase_if(bufferStates_, [vkBuffer, begin, end](const BufferRangeState& s) {
+    return s.buffer == vkBuffer && s.begin < end && s.end > begin;
+  });
+}
+
+void lvk::CommandBuffer::invalidateBufferVisibility() {
+  // shaders can write any buffer via its device address without declaring it, so a tracked write is no longer known to be the last one
+  for (BufferRangeState& s : bufferStates_) {
+    s.visibleStages = VK_PIPELINE_STAGE_2_NONE;
+    s.hasUntrackedWrites = true;
+  }
+}
+
+void lvk::CommandBuffer::flushBarriers() {
+  barriers_.flush();
+}
+
+void lvk::CommandBuffer::useRenderingDependencies(const lvk::RenderPass& renderPass,
+                                                  const lvk::Framebuffer& fb,
+                                                  const Dependencies& deps) {
   for (uint32_t i = 0; i != Dependencies::LVK_MAX_SUBMIT_DEPENDENCIES && deps.textures[i]; i++) {
     transitionToShaderReadOnly(deps.textures[i]);
   }
   for (uint32_t i = 0; i != Dependencies::LVK_MAX_SUBMIT_DEPENDENCIES && deps.buffers[i]; i++) {
-    VkPipelineStageFlags dstStageFlags = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    VkPipelineStageFlags2 dstStageFlags = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+    VkAccessFlags2 dstAccessFlags = VK_ACCESS_2_SHADER_READ_BIT;
     const lvk::VulkanBuffer* buf = ctx_->buffersPool_.get(deps.buffers[i]);
     LVK_ASSERT(buf);
-    if ((buf->vkUsageFlags_ & VK_BUFFER_USAGE_INDEX_BUFFER_BIT) || (buf->vkUsageFlags_ & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)) {
-      dstStageFlags |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    if (buf->vkUsageFlags_ & VK_BUFFER_USAGE_INDEX_BUFFER_BIT) {
+      dstStageFlags |= VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT;
+      dstAccessFlags |= VK_ACCESS_2_INDEX_READ_BIT;
+    }
+    if (buf->vkUsageFlags_ & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT) {
+      dstStageFlags |= VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT;
+      dstAccessFlags |= VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT;
     }
     if (buf->vkUsageFlags_ & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) {
-      dstStageFlags |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+      dstStageFlags |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+      dstAccessFlags |= VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
     }
-    bufferBarrier(deps.buffers[i], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dstStageFlags);
+    useBufferRange(deps.buffers[i],
+                   deps.bufferOffsets[i],
+                   deps.bufferSizes[i],
+                   dstStageFlags,
+                   dstAccessFlags,
+                   false,
+                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_2_SHADER_WRITE_BIT);
   }
 
-  const uint32_t numFbColorAttachments = fb.getNumColorAttachments();
-  const uint32_t numPassColorAttachments = renderPass.getNumColorAttachments();
-
-  LVK_ASSERT(numPassColorAttachments == numFbColorAttachments);
-
-  framebuffer_ = fb;
-
   // transition all the color attachments
-  for (uint32_t i = 0; i != numFbColorAttachments; i++) {
+  for (uint32_t i = 0; i != fb.getNumColorAttachments(); i++) {
+    const RenderPass::AttachmentDesc& descColor = renderPass.color[i];
     if (const auto handle = fb.color[i].texture) {
       lvk::VulkanImage* colorTex = ctx_->texturesPool_.get(handle);
-      transitionToColorAttachment(wrapper_->cmdBuf_, colorTex);
+      transitionToColorAttachment(barriers_, colorTex, descColor.level, descColor.layer);
     }
     // handle MSAA
     if (TextureHandle handle = fb.color[i].resolveTexture) {
       lvk::VulkanImage* colorResolveTex = ctx_->texturesPool_.get(handle);
-      transitionToColorAttachment(wrapper_->cmdBuf_, colorResolveTex);
+      transitionToColorAttachment(barriers_, colorResolveTex, descColor.level, descColor.layer);
     }
   }
+  const RenderPass::AttachmentDesc& descDepth = renderPass.depth;
   // transition depth-stencil attachment
   TextureHandle depthTex = fb.depthStencil.texture;
   if (depthTex) {
     const lvk::VulkanImage& depthImg = *ctx_->texturesPool_.get(depthTex);
     LVK_ASSERT_MSG(depthImg.vkImageFormat_ != VK_FORMAT_UNDEFINED, "Invalid depth attachment format");
     const VkImageAspectFlags flags = depthImg.getImageAspectFlags();
-    depthImg.transitionLayout(wrapper_->cmdBuf_,
+    depthImg.transitionLayout(barriers_,
                               VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
                               VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
                               VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, // wait for all subsequent
                                                                                                               // operations
-                              VkImageSubresourceRange{flags, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+                              VkImageSubresourceRange{flags, descDepth.level, 1, descDepth.layer, 1});
+  }
+  if (TextureHandle handle = fb.depthStencil.resolveTexture) {
+    const lvk::VulkanImage& depthResolveImg = *ctx_->texturesPool_.get(handle);
+    depthResolveImg.transitionLayout(barriers_,
+                                     VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                                     VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                     VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                     VkImageSubresourceRange{
+                                         depthResolveImg.getImageAspectFlags(), descDepth.level, 1, descDepth.layer, 1});
+  }
+}
+
+void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, const lvk::Framebuffer& fb, const Dependencies& deps) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT(!isRendering_);
+
+  isRendering_ = true;
+
+  const uint32_t numFbColorAttachments = fb.getNumColorAttachments();
+  const uint32_t numPassColorAttachments = renderPass.getNumColorAttachments();
+
+  LVK_ASSERT(numPassColorAttachments == numFbColorAttachments);
+
+  framebuffer_ = fb;
+  renderPass_ = renderPass;
+
+  if (automaticBarriers_) {
+    useRenderingDependencies(renderPass, fb, deps);
   }
 
+  // all dependencies and attachment transitions go into one vkCmdPipelineBarrier2()
+  flushBarriers();
+
   VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
   uint32_t mipLevel = 0;
   uint32_t fbWidth = 0;
@@ -2014,7 +3117,7 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
         .pNext = nullptr,
         .imageView = colorTexture.getOrCreateVkImageViewForFramebuffer(*ctx_, descColor.level, descColor.layer),
         .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        .resolveMode = (samples > 1) ? VK_RESOLVE_MODE_AVERAGE_BIT : VK_RESOLVE_MODE_NONE,
+        .resolveMode = VK_RESOLVE_MODE_NONE,
         .resolveImageView = VK_NULL_HANDLE,
         .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
         .loadOp = loadOpToVkAttachmentLoadOp(descColor.loadOp),
@@ -2027,6 +3130,7 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
       LVK_ASSERT(samples > 1);
       LVK_ASSERT_MSG(!attachment.resolveTexture.empty(), "Framebuffer attachment should contain a resolve texture");
       lvk::VulkanImage& colorResolveTexture = *ctx_->texturesPool_.get(attachment.resolveTexture);
+      colorAttachments[i].resolveMode = resolveModeToVkResolveModeFlagBits(descColor.resolveMode, ~VkResolveModeFlags{});
       colorAttachments[i].resolveImageView =
           colorResolveTexture.getOrCreateVkImageViewForFramebuffer(*ctx_, descColor.level, descColor.layer);
       colorAttachments[i].resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
@@ -2051,6 +3155,14 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
         .storeOp = storeOpToVkAttachmentStoreOp(descDepth.storeOp),
         .clearValue = {.depthStencil = {.depth = descDepth.clearDepth, .stencil = descDepth.clearStencil}},
     };
+    if (fb.depthStencil.resolveTexture && depthTexture.vkSamples_ > 1) {
+      lvk::VulkanImage& depthResolveTexture = *ctx_->texturesPool_.get(fb.depthStencil.resolveTexture);
+      LVK_ASSERT_MSG(depthResolveTexture.vkImageFormat_ == depthTexture.vkImageFormat_, "Depth resolve texture format mismatch");
+      depthAttachment.resolveMode = resolveModeToVkResolveModeFlagBits(
+          descDepth.resolveMode, ctx_->getVkPhysicalDeviceVulkan12Properties().supportedDepthResolveModes);
+      depthAttachment.resolveImageView = depthResolveTexture.getOrCreateVkImageViewForFramebuffer(*ctx_, descDepth.level, descDepth.layer);
+      depthAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    }
     const VkExtent3D dim = depthTexture.vkExtent_;
     if (fbWidth) {
       LVK_ASSERT_MSG(dim.width == fbWidth, "All attachments should have the save width");
@@ -2072,10 +3184,18 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
 
   const bool isStencilFormat = renderPass.stencil.loadOp != lvk::LoadOp_Invalid;
 
+  if (isStencilFormat && depthAttachment.resolveMode != VK_RESOLVE_MODE_NONE) {
+    // sample zero is the only stencil resolve mode which is always supported
+    stencilAttachment.resolveMode = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+    if (!ctx_->getVkPhysicalDeviceVulkan12Properties().independentResolve) {
+      depthAttachment.resolveMode = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+    }
+  }
+
   const VkRenderingInfo renderingInfo = {
       .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
       .pNext = nullptr,
-      .flags = 0,
+      .flags = renderPass.executesBundles ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0u,
       .renderArea = {VkOffset2D{(int32_t)scissor.x, (int32_t)scissor.y}, VkExtent2D{scissor.width, scissor.height}},
       .layerCount = 1,
       .viewMask = 0,
@@ -2085,15 +3205,13 @@ void lvk::CommandBuffer::cmdBeginRendering(const lvk::RenderPass& renderPass, co
       .pStencilAttachment = isStencilFormat ? &stencilAttachment : nullptr,
   };
 
+  resetRenderingState();
+
   cmdBindViewport(viewport);
   cmdBindScissorRect(scissor);
-  cmdBindDepthState({});
 
   ctx_->checkAndUpdateDescriptorSets();
 
-  vkCmdSetDepthCompareOp(wrapper_->cmdBuf_, VK_COMPARE_OP_ALWAYS);
-  vkCmdSetDepthBiasEnable(wrapper_->cmdBuf_, VK_FALSE);
-
   vkCmdBeginRendering(wrapper_->cmdBuf_, &renderingInfo);
 }
 
@@ -2104,23 +3222,54 @@ void lvk::CommandBuffer::cmdEndRendering() {
 
   vkCmdEndRendering(wrapper_->cmdBuf_);
 
+  // covers every draw call of this render pass
+  invalidateBufferVisibility();
+
   const uint32_t numFbColorAttachments = framebuffer_.getNumColorAttachments();
 
-  // set image layouts after the render pass
+  // set layouts and last accesses of the rendered subresources; layouts must match the final layouts of the render pass
+  const VulkanImage::SubresourceState colorState = {
+      .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+      .stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+      .writes = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+  };
   for (uint32_t i = 0; i != numFbColorAttachments; i++) {
     const auto& attachment = framebuffer_.color[i];
+    const RenderPass::AttachmentDesc& desc = renderPass_.color[i];
     const VulkanImage& tex = *ctx_->texturesPool_.get(attachment.texture);
-    // this must match the final layout of the render pass
-    tex.vkImageLayout_ = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    tex.setSubresourceState(VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, desc.level, 1, desc.layer, 1}, colorState);
+    if (attachment.resolveTexture) {
+      const VulkanImage& resolveTex = *ctx_->texturesPool_.get(attachment.resolveTexture);
+      resolveTex.setSubresourceState(VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, desc.level, 1, desc.layer, 1}, colorState);
+    }
   }
 
+  const RenderPass::AttachmentDesc& descDepth = renderPass_.depth;
   if (framebuffer_.depthStencil.texture) {
     const VulkanImage& tex = *ctx_->texturesPool_.get(framebuffer_.depthStencil.texture);
-    // this must match the final layout of the render pass
-    tex.vkImageLayout_ = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    // depth resolves read the depth attachment in the color attachment output stage
+    const VkPipelineStageFlags2 resolveStage =
+        framebuffer_.depthStencil.resolveTexture ? VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT : VK_PIPELINE_STAGE_2_NONE;
+    tex.setSubresourceState(VkImageSubresourceRange{tex.getImageAspectFlags(), descDepth.level, 1, descDepth.layer, 1},
+                            {
+                                .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                                .stages = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT |
+                                          resolveStage,
+                                .writes = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                            });
+  }
+  if (framebuffer_.depthStencil.resolveTexture) {
+    const VulkanImage& tex = *ctx_->texturesPool_.get(framebuffer_.depthStencil.resolveTexture);
+    tex.setSubresourceState(VkImageSubresourceRange{tex.getImageAspectFlags(), descDepth.level, 1, descDepth.layer, 1},
+                            {
+                                .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                                .stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                .writes = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                            });
   }
 
   framebuffer_ = {};
+  renderPass_ = {};
 }
 
 void lvk::CommandBuffer::cmdBindViewport(const Viewport& viewport) {
@@ -2133,6 +3282,12 @@ void lvk::CommandBuffer::cmdBindViewport(const Viewport& viewport) {
       .minDepth = viewport.minDepth, // float minDepth;
       .maxDepth = viewport.maxDepth, // float maxDepth;
   };
+  if (state_.hasViewport && !memcmp(&state_.viewport, &vp, sizeof(vp))) {
+    stats_.skippedViewports++;
+    return;
+  }
+  state_.viewport = vp;
+  state_.hasViewport = true;
   vkCmdSetViewport(wrapper_->cmdBuf_, 0, 1, &vp);
 }
 
@@ -2141,6 +3296,12 @@ void lvk::CommandBuffer::cmdBindScissorRect(const ScissorRect& rect) {
       VkOffset2D{(int32_t)rect.x, (int32_t)rect.y},
       VkExtent2D{rect.width, rect.height},
   };
+  if (state_.hasScissor && !memcmp(&state_.scissor, &scissor, sizeof(scissor))) {
+    stats_.skippedScissorRects++;
+    return;
+  }
+  state_.scissor = scissor;
+  state_.hasScissor = true;
   vkCmdSetScissor(wrapper_->cmdBuf_, 0, 1, &scissor);
 }
 
@@ -2157,7 +3318,7 @@ void lvk::CommandBuffer::cmdBindRenderPipeline(lvk::RenderPipelineHandle handle)
   LVK_ASSERT(rps);
 
   const bool hasDepthAttachmentPipeline = rps->desc_.depthFormat != Format_Invalid;
-  const bool hasDepthAttachmentPass = !framebuffer_.depthStencil.texture.empty();
+  const bool hasDepthAttachmentPass = bundle_ ? bundle_->desc_.depthFormat != Format_Invalid : !framebuffer_.depthStencil.texture.empty();
 
   if (hasDepthAttachmentPipeline != hasDepthAttachmentPass) {
     LVK_ASSERT(false);
@@ -2168,10 +3329,21 @@ void lvk::CommandBuffer::cmdBindRenderPipeline(lvk::RenderPipelineHandle handle)
 
   LVK_ASSERT(pipeline != VK_NULL_HANDLE);
 
+  if (bundle_) {
+    // the bundle is re-recorded when any of its pipelines is rebuilt
+    auto& pipelines = bundle_->pipelines_;
+    if (std::find_if(pipelines.begin(), pipelines.end(), [handle](const auto& p) { return p.first == handle; }) == pipelines.end()) {
+      pipelines.emplace_back(handle, pipeline);
+    }
+  }
+
   if (lastPipelineBound_ != pipeline) {
     lastPipelineBound_ = pipeline;
     vkCmdBindPipeline(wrapper_->cmdBuf_, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
     ctx_->bindDefaultDescriptorSets(wrapper_->cmdBuf_, VK_PIPELINE_BIND_POINT_GRAPHICS, rps->pipelineLayout_);
+    onPipelineLayoutBound(rps->pipelineLayout_);
+  } else {
+    stats_.skippedPipelineBinds++;
   }
 }
 
@@ -2179,8 +3351,23 @@ void lvk::CommandBuffer::cmdBindDepthState(const DepthState& desc) {
   LVK_PROFILER_FUNCTION();
 
   const VkCompareOp op = compareOpToVkCompareOp(desc.compareOp);
-  vkCmdSetDepthWriteEnable(wrapper_->cmdBuf_, desc.isDepthWriteEnabled ? VK_TRUE : VK_FALSE);
-  vkCmdSetDepthTestEnable(wrapper_->cmdBuf_, !(op == VK_COMPARE_OP_ALWAYS && !desc.isDepthWriteEnabled));
+  const VkBool32 writeEnable = desc.isDepthWriteEnabled ? VK_TRUE : VK_FALSE;
+  const VkBool32 testEnable = !(op == VK_COMPARE_OP_ALWAYS && !desc.isDepthWriteEnabled) ? VK_TRUE : VK_FALSE;
+
+  if (state_.hasDepthWriteEnable && state_.depthWriteEnable == writeEnable) {
+    stats_.skippedDepthStates++;
+  } else {
+    state_.depthWriteEnable = writeEnable;
+    state_.hasDepthWriteEnable = true;
+    vkCmdSetDepthWriteEnable(wrapper_->cmdBuf_, writeEnable);
+  }
+  if (state_.hasDepthTestEnable && state_.depthTestEnable == testEnable) {
+    stats_.skippedDepthStates++;
+  } else {
+    state_.depthTestEnable = testEnable;
+    state_.hasDepthTestEnable = true;
+    vkCmdSetDepthTestEnable(wrapper_->cmdBuf_, testEnable);
+  }
 
 #if defined(ANDROID)
   // This is a workaround for the issue.
@@ -2190,6 +3377,11 @@ void lvk::CommandBuffer::cmdBindDepthState(const DepthState& desc) {
     return;
   }
 #endif
+  if (state_.depthCompareOp == op) {
+    stats_.skippedDepthStates++;
+    return;
+  }
+  state_.depthCompareOp = op;
   vkCmdSetDepthCompareOp(wrapper_->cmdBuf_, op);
 }
 
@@ -2204,7 +3396,18 @@ void lvk::CommandBuffer::cmdBindVertexBuffer(uint32_t index, BufferHandle buffer
 
   LVK_ASSERT(buf->vkUsageFlags_ & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
 
-  vkCmdBindVertexBuffers(wrapper_->cmdBuf_, index, 1, &buf->vkBuffer_, &bufferOffset);
+  const VkDeviceSize offset = buf->bufferOffset_ + bufferOffset;
+
+  if (index < VertexInput::LVK_VERTEX_BUFFER_MAX) {
+    if (state_.vertexBuffers[index] == buf->vkBuffer_ && state_.vertexBufferOffsets[index] == offset) {
+      stats_.skippedVertexBufferBinds++;
+      return;
+    }
+    state_.vertexBuffers[index] = buf->vkBuffer_;
+    state_.vertexBufferOffsets[index] = offset;
+  }
+
+  vkCmdBindVertexBuffers(wrapper_->cmdBuf_, index, 1, &buf->vkBuffer_, &offset);
 }
 
 void lvk::CommandBuffer::cmdBindIndexBuffer(BufferHandle indexBuffer, IndexFormat indexFormat, uint64_t indexBufferOffset) {
@@ -2213,7 +3416,17 @@ void lvk::CommandBuffer::cmdBindIndexBuffer(BufferHandle indexBuffer, IndexForma
   LVK_ASSERT(buf->vkUsageFlags_ & VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
 
   const VkIndexType type = indexFormatToVkIndexType(indexFormat);
-  vkCmdBindIndexBuffer(wrapper_->cmdBuf_, buf->vkBuffer_, indexBufferOffset, type);
+  const VkDeviceSize offset = buf->bufferOffset_ + indexBufferOffset;
+
+  if (state_.indexBuffer == buf->vkBuffer_ && state_.indexBufferOffset == offset && state_.indexType == type) {
+    stats_.skippedIndexBufferBinds++;
+    return;
+  }
+  state_.indexBuffer = buf->vkBuffer_;
+  state_.indexBufferOffset = offset;
+  state_.indexType = type;
+
+  vkCmdBindIndexBuffer(wrapper_->cmdBuf_, buf->vkBuffer_, offset, type);
 }
 
 void lvk::CommandBuffer::cmdPushConstants(const void* data, size_t size, size_t offset) {
@@ -2240,6 +3453,21 @@ void lvk::CommandBuffer::cmdPushConstants(const void* data, size_t size, size_t
   VkPipelineLayout layout = stateGraphics ? stateGraphics->pipelineLayout_ : stateCompute->pipelineLayout_;
   VkShaderStageFlags shaderStageFlags = stateGraphics ? stateGraphics->shaderStageFlags_ : VK_SHADER_STAGE_COMPUTE_BIT;
 
+  if (state_.pushConstantsLayout == layout && state_.pushConstantsOffset == offset && state_.pushConstantsSize == size &&
+      !memcmp(state_.pushConstants, data, size)) {
+    stats_.skippedPushConstants++;
+    return;
+  }
+
+  if (size <= ShadowState::kMaxPushConstantsSize) {
+    state_.pushConstantsLayout = layout;
+    state_.pushConstantsOffset = (uint32_t)offset;
+    state_.pushConstantsSize = (uint32_t)size;
+    memcpy(state_.pushConstants, data, size);
+  } else {
+    state_.pushConstantsLayout = VK_NULL_HANDLE;
+  }
+
   vkCmdPushConstants(wrapper_->cmdBuf_, layout, shaderStageFlags, (uint32_t)offset, (uint32_t)size, data);
 }
 
@@ -2267,6 +3495,115 @@ void lvk::CommandBuffer::cmdDrawIndexed(uint32_t indexCount,
   vkCmdDrawIndexed(wrapper_->cmdBuf_, indexCount, instanceCount, firstIndex, vertexOffset, baseInstance);
 }
 
+static_assert(sizeof(lvk::DrawInfo) == sizeof(VkMultiDrawInfoEXT));
+static_assert(offsetof(lvk::DrawInfo, firstVertex) == offsetof(VkMultiDrawInfoEXT, firstVertex));
+static_assert(offsetof(lvk::DrawInfo, vertexCount) == offsetof(VkMultiDrawInfoEXT, vertexCount));
+static_assert(sizeof(lvk::DrawIndexedInfo) == sizeof(VkMultiDrawIndexedInfoEXT));
+static_assert(offsetof(lvk::DrawIndexedInfo, firstIndex) == offsetof(VkMultiDrawIndexedInfoEXT, firstIndex));
+static_assert(offsetof(lvk::DrawIndexedInfo, indexCount) == offsetof(VkMultiDrawIndexedInfoEXT, indexCount));
+static_assert(offsetof(lvk::DrawIndexedInfo, vertexOffset) == offsetof(VkMultiDrawIndexedInfoEXT, vertexOffset));
+
+void lvk::CommandBuffer::cmdDrawMulti(const DrawInfo* draws, uint32_t numDraws, uint32_t instanceCount, uint32_t baseInstance) {
+  LVK_PROFILER_FUNCTION();
+
+  if (!numDraws || !instanceCount) {
+    return;
+  }
+
+  LVK_ASSERT(draws);
+
+  if (ctx_->hasMultiDraw_) {
+    for (uint32_t first = 0; first < numDraws; first += ctx_->maxMultiDrawCount_) {
+      const uint32_t count = std::min(numDraws - first, ctx_->maxMultiDrawCount_);
+      vkCmdDrawMultiEXT(wrapper_->cmdBuf_,
+                        count,
+                        reinterpret_cast<const VkMultiDrawInfoEXT*>(draws + first),
+                        instanceCount,
+                        baseInstance,
+                        sizeof(DrawInfo));
+    }
+    return;
+  }
+
+  // transient memory is recycled every frame, while a command bundle can be replayed for many frames
+  const TransientAllocation mem = ctx_->transientAllocator_ && !bundle_
+                                      ? ctx_->allocateTransient(numDraws * sizeof(VkDrawIndirectCommand), sizeof(uint32_t))
+                                      : TransientAllocation{};
+
+  if (!mem.valid()) {
+    for (uint32_t i = 0; i != numDraws; i++) {
+      cmdDraw(draws[i].vertexCount, instanceCount, draws[i].firstVertex, baseInstance);
+    }
+    return;
+  }
+
+  VkDrawIndirectCommand* cmds = static_cast<VkDrawIndirectCommand*>(mem.ptr);
+
+  for (uint32_t i = 0; i != numDraws; i++) {
+    cmds[i] = {
+        .vertexCount = draws[i].vertexCount,
+        .instanceCount = instanceCount,
+        .firstVertex = draws[i].firstVertex,
+        .firstInstance = baseInstance,
+    };
+  }
+
+  cmdDrawIndirect(mem.buffer, mem.offset, numDraws, sizeof(VkDrawIndirectCommand));
+}
+
+void lvk::CommandBuffer::cmdDrawIndexedMulti(const DrawIndexedInfo* draws,
+                                             uint32_t numDraws,
+                                             uint32_t instanceCount,
+                                             uint32_t baseInstance) {
+  LVK_PROFILER_FUNCTION();
+
+  if (!numDraws || !instanceCount) {
+    return;
+  }
+
+  LVK_ASSERT(draws);
+
+  if (ctx_->hasMultiDraw_) {
+    for (uint32_t first = 0; first < numDraws; first += ctx_->maxMultiDrawCount_) {
+      const uint32_t count = std::min(numDraws - first, ctx_->maxMultiDrawCount_);
+      vkCmdDrawMultiIndexedEXT(wrapper_->cmdBuf_,
+                               count,
+                               reinterpret_cast<const VkMultiDrawIndexedInfoEXT*>(draws + first),
+                               instanceCount,
+                               baseInstance,
+                               sizeof(DrawIndexedInfo),
+                               nullptr);
+    }
+    return;
+  }
+
+  // transient memory is recycled every frame, while a command bundle can be replayed for many frames
+  const TransientAllocation mem = ctx_->transientAllocator_ && !bundle_
+                                      ? ctx_->allocateTransient(numDraws * sizeof(VkDrawIndexedIndirectCommand), sizeof(uint32_t))
+                                      : TransientAllocation{};
+
+  if (!mem.valid()) {
+    for (uint32_t i = 0; i != numDraws; i++) {
+      cmdDrawIndexed(draws[i].indexCount, instanceCount, draws[i].firstIndex, draws[i].vertexOffset, baseInstance);
+    }
+    return;
+  }
+
+  VkDrawIndexedIndirectCommand* cmds = static_cast<VkDrawIndexedIndirectCommand*>(mem.ptr);
+
+  for (uint32_t i = 0; i != numDraws; i++) {
+    cmds[i] = {
+        .indexCount = draws[i].indexCount,
+        .instanceCount = instanceCount,
+        .firstIndex = draws[i].firstIndex,
+        .vertexOffset = draws[i].vertexOffset,
+        .firstInstance = baseInstance,
+    };
+  }
+
+  cmdDrawIndexedIndirect(mem.buffer, mem.offset, numDraws, sizeof(VkDrawIndexedIndirectCommand));
+}
+
 void lvk::CommandBuffer::cmdDrawIndirect(BufferHandle indirectBuffer, size_t indirectBufferOffset, uint32_t drawCount, uint32_t stride) {
   LVK_PROFILER_FUNCTION();
 
@@ -2274,8 +3611,11 @@ void lvk::CommandBuffer::cmdDrawIndirect(BufferHandle indirectBuffer, size_t ind
 
   LVK_ASSERT(bufIndirect);
 
-  vkCmdDrawIndirect(
-      wrapper_->cmdBuf_, bufIndirect->vkBuffer_, indirectBufferOffset, drawCount, stride ? stride : sizeof(VkDrawIndirectCommand));
+  vkCmdDrawIndirect(wrapper_->cmdBuf_,
+                    bufIndirect->vkBuffer_,
+                    bufIndirect->bufferOffset_ + indirectBufferOffset,
+                    drawCount,
+                    stride ? stride : sizeof(VkDrawIndirectCommand));
 }
 
 void lvk::CommandBuffer::cmdDrawIndexedIndirect(BufferHandle indirectBuffer,
@@ -2288,8 +3628,11 @@ void lvk::CommandBuffer::cmdDrawIndexedIndirect(BufferHandle indirectBuffer,
 
   LVK_ASSERT(bufIndirect);
 
-  vkCmdDrawIndexedIndirect(
-      wrapper_->cmdBuf_, bufIndirect->vkBuffer_, indirectBufferOffset, drawCount, stride ? stride : sizeof(VkDrawIndexedIndirectCommand));
+  vkCmdDrawIndexedIndirect(wrapper_->cmdBuf_,
+                           bufIndirect->vkBuffer_,
+                           bufIndirect->bufferOffset_ + indirectBufferOffset,
+                           drawCount,
+                           stride ? stride : sizeof(VkDrawIndexedIndirectCommand));
 }
 
 void lvk::CommandBuffer::cmdDrawIndexedIndirectCount(BufferHandle indirectBuffer,
@@ -2308,20 +3651,41 @@ void lvk::CommandBuffer::cmdDrawIndexedIndirectCount(BufferHandle indirectBuffer
 
   vkCmdDrawIndexedIndirectCount(wrapper_->cmdBuf_,
                                 bufIndirect->vkBuffer_,
-                                indirectBufferOffset,
+                                bufIndirect->bufferOffset_ + indirectBufferOffset,
                                 bufCount->vkBuffer_,
-                                countBufferOffset,
+                                bufCount->bufferOffset_ + countBufferOffset,
                                 maxDrawCount,
                                 stride ? stride : sizeof(VkDrawIndexedIndirectCommand));
 }
 
 void lvk::CommandBuffer::cmdSetBlendColor(const float color[4]) {
+  if (state_.hasBlendColor && !memcmp(state_.blendColor, color, sizeof(state_.blendColor))) {
+    stats_.skippedBlendColors++;
+    return;
+  }
+  memcpy(state_.blendColor, color, sizeof(state_.blendColor));
+  state_.hasBlendColor = true;
   vkCmdSetBlendConstants(wrapper_->cmdBuf_, color);
 }
 
 void lvk::CommandBuffer::cmdSetDepthBias(float depthBias, float slopeScale, float clamp) {
-  vkCmdSetDepthBias(wrapper_->cmdBuf_, depthBias, clamp, slopeScale);
-  vkCmdSetDepthBiasEnable(wrapper_->cmdBuf_, depthBias != 0);
+  const float bias[3] = {depthBias, clamp, slopeScale};
+  const VkBool32 enable = depthBias != 0 ? VK_TRUE : VK_FALSE;
+
+  if (state_.hasDepthBias && !memcmp(state_.depthBias, bias, sizeof(bias))) {
+    stats_.skippedDepthBiases++;
+  } else {
+    memcpy(state_.depthBias, bias, sizeof(bias));
+    state_.hasDepthBias = true;
+    vkCmdSetDepthBias(wrapper_->cmdBuf_, depthBias, clamp, slopeScale);
+  }
+  if (state_.hasDepthBiasEnable && state_.depthBiasEnable == enable) {
+    stats_.skippedDepthBiases++;
+  } else {
+    state_.depthBiasEnable = enable;
+    state_.hasDepthBiasEnable = true;
+    vkCmdSetDepthBiasEnable(wrapper_->cmdBuf_, enable);
+  }
 }
 
 void lvk::CommandBuffer::cmdResetQueryPool(QueryPoolHandle pool, uint32_t firstQuery, uint32_t queryCount) {
@@ -2336,6 +3700,30 @@ void lvk::CommandBuffer::cmdWriteTimestamp(QueryPoolHandle pool, uint32_t query)
   vkCmdWriteTimestamp(wrapper_->cmdBuf_, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, vkPool, query);
 }
 
+void lvk::CommandBuffer::cmdExecuteBundle(CommandBundleHandle handle) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT_MSG(isRendering_ && renderPass_.executesBundles && !bundle_, "Use RenderPass::executesBundles to execute bundles");
+
+  lvk::CommandBundleState* bundle = ctx_->commandBundlesPool_.get(handle);
+
+  if (!LVK_VERIFY(bundle)) {
+    return;
+  }
+
+  if (!ctx_->updateCommandBundle(*bundle).isOk()) {
+    return;
+  }
+
+  vkCmdExecuteCommands(wrapper_->cmdBuf_, 1, &bundle->wrapper_.cmdBuf_);
+
+  // the dynamic state and bindings of the primary command buffer are undefined after vkCmdExecuteCommands()
+  state_ = {};
+  lastPipelineBound_ = VK_NULL_HANDLE;
+  lastPipelineLayoutBound_ = VK_NULL_HANDLE;
+  currentPipelineGraphics_ = {};
+}
+
 lvk::VulkanStagingDevice::VulkanStagingDevice(VulkanContext& ctx) : ctx_(ctx) {
   LVK_PROFILER_FUNCTION();
 
@@ -2361,9 +3749,11 @@ void lvk::VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer, size_t dstOff
   lvk::VulkanBuffer* stagingBuffer = ctx_.buffersPool_.get(stagingBuffer_);
 
   while (size) {
+    // clamp before narrowing: uploads of 4 GiB and more do not fit into uint32_t; the staging buffer never grows beyond maxBufferSize_
+    const uint32_t maxChunkSize = (uint32_t)std::min<size_t>(size, maxBufferSize_);
     // get next staging buffer free offset
-    MemoryRegionDesc desc = getNextFreeOffset((uint32_t)size);
-    const uint32_t chunkSize = std::min((uint32_t)size, desc.size_);
+    MemoryRegionDesc desc = getNextFreeOffset(maxChunkSize);
+    const uint32_t chunkSize = std::min(maxChunkSize, desc.size_);
 
     // copy data into staging buffer
     stagingBuffer->bufferSubData(ctx_, desc.offset_, chunkSize, data);
@@ -2371,7 +3761,7 @@ void lvk::VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer, size_t dstOff
     // do the transfer
     const VkBufferCopy copy = {
         .srcOffset = desc.offset_,
-        .dstOffset = dstOffset,
+        .dstOffset = buffer.bufferOffset_ + dstOffset,
         .size = chunkSize,
     };
 
@@ -2384,7 +3774,7 @@ void lvk::VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer, size_t dstOff
         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
         .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
         .buffer = buffer.vkBuffer_,
-        .offset = dstOffset,
+        .offset = buffer.bufferOffset_ + dstOffset,
         .size = chunkSize,
     };
     VkPipelineStageFlags dstMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
@@ -2517,7 +3907,9 @@ void lvk::VulkanStagingDevice::imageData2D(VulkanImage& image,
     }
   }
 
-  image.vkImageLayout_ = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  // only the uploaded subresources change their layout; the rest of the image keeps its tracked state
+  image.setSubresourceState(VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, baseMipLevel, numMipLevels, 0, numLayers},
+                            {.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
 
   desc.handle_ = immediate_->submit(wrapper);
   regions_.push_back(desc);
@@ -2589,7 +3981,8 @@ void lvk::VulkanStagingDevice::imageData3D(VulkanImage& image,
                           VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                           VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
 
-  image.vkImageLayout_ = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  image.setSubresourceState(VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
+                            {.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
 
   desc.handle_ = immediate_->submit(wrapper);
   regions_.push_back(desc);
@@ -2601,7 +3994,9 @@ void lvk::VulkanStagingDevice::getImageData(VulkanImage& image,
                                             VkImageSubresourceRange range,
                                             VkFormat format,
                                             void* outData) {
-  LVK_ASSERT(image.vkImageLayout_ != VK_IMAGE_LAYOUT_UNDEFINED);
+  const VkImageLayout layout = image.getSubresourceLayout(range.baseMipLevel, range.baseArrayLayer);
+
+  LVK_ASSERT(layout != VK_IMAGE_LAYOUT_UNDEFINED);
   LVK_ASSERT(range.layerCount == 1);
 
   const uint32_t storageSize = extent.width * extent.height * extent.depth * getBytesPerPixel(format);
@@ -2629,7 +4024,7 @@ void lvk::VulkanStagingDevice::getImageData(VulkanImage& image,
                           image.vkImage_,
                           0, // srcAccessMask
                           VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT, // dstAccessMask
-                          image.vkImageLayout_,
+                          layout,
                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                           VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, // wait for all previous operations
                           VK_PIPELINE_STAGE_TRANSFER_BIT, // dstStageMask
@@ -2672,7 +4067,7 @@ void lvk::VulkanStagingDevice::getImageData(VulkanImage& image,
                           VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT, // srcAccessMask
                           0, // dstAccessMask
                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                          image.vkImageLayout_,
+                          layout,
                           VK_PIPELINE_STAGE_TRANSFER_BIT, // srcStageMask
                           VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // dstStageMask
                           range);
@@ -2794,6 +4189,18 @@ lvk::VulkanStagingDevice::MemoryRegionDesc lvk::VulkanStagingDevice::getNextFree
   };
 }
 
+void lvk::VulkanStagingDevice::getMemoryUsage(uint64_t& outSize, uint64_t& outInUse) const {
+  outSize = stagingBufferSize_;
+  outInUse = stagingBufferSize_;
+
+  // everything which is not in a completed region is being used by the GPU
+  for (const auto& r : regions_) {
+    if (immediate_->isReady(r.handle_)) {
+      outInUse -= r.size_;
+    }
+  }
+}
+
 void lvk::VulkanStagingDevice::waitAndReset() {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_WAIT);
 
@@ -2805,12 +4212,137 @@ void lvk::VulkanStagingDevice::waitAndReset() {
   regions_.push_front({0, stagingBufferSize_, SubmitHandle()});
 }
 
+lvk::VulkanTransientAllocator::VulkanTransientAllocator(VulkanContext& ctx, size_t size) : ctx_(ctx), size_(size) {
+  LVK_ASSERT(size_);
+}
+
+lvk::TransientAllocation lvk::VulkanTransientAllocator::allocate(size_t size, size_t alignment) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT_MSG(alignment && (alignment & (alignment - 1)) == 0, "Alignment should be a power of 2");
+
+  if (!LVK_VERIFY(size && size <= size_)) {
+    LLOGW("Invalid transient allocation size %zu (max %zu bytes)\n", size, size_);
+    return {};
+  }
+
+  // lazily create the ring buffer on first use
+  if (buffer_.empty()) {
+    Result result;
+    buffer_ = {&ctx_,
+               ctx_.createBuffer(size_,
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                                     VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                 &result,
+                                 "Buffer: transient ring")};
+    if (!LVK_VERIFY(result.isOk())) {
+      buffer_ = nullptr;
+      return {};
+    }
+    const lvk::VulkanBuffer* buf = ctx_.buffersPool_.get(buffer_);
+    mappedPtr_ = buf->getMappedPtr();
+    gpuAddress_ = buf->vkDeviceAddress_;
+    LVK_ASSERT(mappedPtr_);
+  }
+
+  retireCompletedFrames();
+
+  size_t offset = 0;
+
+  while (!tryAllocate(size, alignment, offset)) {
+    if (frames_.empty()) {
+      LLOGW("Transient ring buffer overflow: %zu bytes requested within a single frame (ring size %zu bytes)\n", size, size_);
+      return {};
+    }
+    // stall until the oldest frame in flight is done
+    ctx_.immediate_->wait(frames_.front().handle_);
+    frames_.pop_front();
+  }
+
+  return {
+      .ptr = mappedPtr_ + offset,
+      .gpuAddress = gpuAddress_ + offset,
+      .buffer = buffer_,
+      .offset = offset,
+  };
+}
+
+bool lvk::VulkanTransientAllocator::tryAllocate(size_t size, size_t alignment, size_t& outOffset) {
+  const bool isEmpty = frames_.empty() && isFrameEmpty_;
+
+  if (isEmpty) {
+    // nothing is in flight - start over from the beginning of the ring
+    head_ = 0;
+    frameBegin_ = 0;
+  }
+
+  const size_t tail = getTail();
+  const size_t offset = (head_ + alignment - 1) & ~(alignment - 1);
+
+  if (isEmpty || head_ > tail) {
+    // free space is [head_, size_) and [0, tail)
+    if (offset + size <= size_) {
+      outOffset = offset;
+    } else if (size <= tail) {
+      outOffset = 0;
+    } else {
+      return false;
+    }
+  } else if (head_ < tail && offset + size <= tail) {
+    // free space is [head_, tail)
+    outOffset = offset;
+  } else {
+    // the ring is full
+    return false;
+  }
+
+  head_ = outOffset + size;
+  isFrameEmpty_ = false;
+
+  return true;
+}
+
+void lvk::VulkanTransientAllocator::retireCompletedFrames() {
+  while (!frames_.empty() && ctx_.immediate_->isReady(frames_.front().handle_)) {
+    frames_.pop_front();
+  }
+}
+
+void lvk::VulkanTransientAllocator::flush() {
+  if (buffer_.empty() || isFrameEmpty_) {
+    return;
+  }
+
+  const lvk::VulkanBuffer* buf = ctx_.buffersPool_.get(buffer_);
+
+  if (!buf->isCoherentMemory_) {
+    buf->flushMappedMemory(ctx_, 0, size_);
+  }
+}
+
+void lvk::VulkanTransientAllocator::endFrame(SubmitHandle handle) {
+  if (isFrameEmpty_) {
+    return;
+  }
+
+  frames_.push_back({frameBegin_, head_, handle});
+
+  frameBegin_ = head_;
+  isFrameEmpty_ = true;
+}
+
 lvk::VulkanContext::VulkanContext(const lvk::ContextConfig& config, void* window, void* display, VkSurfaceKHR surface) :
-  config_(config), vkSurface_(surface) {
+  config_(config), vkSurface_(surface), isHeadless_(!window && !surface) {
   LVK_PROFILER_THREAD("MainThread");
 
   pimpl_ = std::make_unique<VulkanContextImpl>();
 
+  numFramesInFlight_ = std::clamp(config_.numFramesInFlight, 1u, (uint32_t)LVK_MAX_FRAMES_IN_FLIGHT);
+
+  // O(1) mapping of shader modules back to handles for validation messages
+  shaderModulesPool_.enableReverseIndex([](const ShaderModuleState& state) { return (uint64_t)state.sm; });
+
   if (volkInitialize() != VK_SUCCESS) {
     LLOGW("volkInitialize() failed\n");
     exit(255);
@@ -2834,11 +4366,14 @@ lvk::VulkanContext::~VulkanContext() {
 
   VK_ASSERT(vkDeviceWaitIdle(vkDevice_));
 
+  transientAllocator_.reset(nullptr);
   stagingDevice_.reset(nullptr);
   swapchain_.reset(nullptr); // swapchain has to be destroyed prior to Surface
 
   destroy(dummyTexture_);
 
+  destroySuballocationBlocks();
+
   if (shaderModulesPool_.numObjects()) {
     LLOGW("Leaked %u shader modules\n", shaderModulesPool_.numObjects());
   }
@@ -2858,22 +4393,39 @@ lvk::VulkanContext::~VulkanContext() {
   if (buffersPool_.numObjects()) {
     LLOGW("Leaked %u buffers\n", buffersPool_.numObjects());
   }
+  if (commandBundlesPool_.numObjects()) {
+    LLOGW("Leaked %u command bundles\n", commandBundlesPool_.numObjects());
+  }
 
   // manually destroy the dummy sampler
-  vkDestroySampler(vkDevice_, samplersPool_.objects_.front().obj_, nullptr);
+  vkDestroySampler(vkDevice_, samplersPool_.objectAt(0), nullptr);
   samplersPool_.clear();
   computePipelinesPool_.clear();
   renderPipelinesPool_.clear();
   shaderModulesPool_.clear();
   texturesPool_.clear();
+  commandBundlesPool_.clear(); // the command buffers go away together with `bundlesCommandPool_`
 
   waitDeferredTasks();
 
+  if (pimpl_->retireThread_.joinable()) {
+    {
+      std::lock_guard lock(pimpl_->retireMutex_);
+      pimpl_->retireThreadExit_ = true;
+    }
+    pimpl_->retireThreadCondition_.notify_all();
+    pimpl_->retireThread_.join();
+  }
+
   immediate_.reset(nullptr);
 
+  vkDestroyCommandPool(vkDevice_, bundlesCommandPool_, nullptr);
   vkDestroyDescriptorSetLayout(vkDevice_, vkDSL_, nullptr);
   vkDestroyDescriptorPool(vkDevice_, vkDPool_, nullptr);
-  vkDestroySurfaceKHR(vkInstance_, vkSurface_, nullptr);
+  if (vkSurface_ != VK_NULL_HANDLE) {
+    // VK_KHR_surface is not enabled for headless contexts
+    vkDestroySurfaceKHR(vkInstance_, vkSurface_, nullptr);
+  }
   vkDestroyPipelineCache(vkDevice_, pipelineCache_, nullptr);
 
   // Clean up VMA
@@ -2896,6 +4448,9 @@ lvk::ICommandBuffer& lvk::VulkanContext::acquireCommandBuffer() {
   LVK_PROFILER_FUNCTION();
 
   LVK_ASSERT_MSG(!pimpl_->currentCommandBuffer_.ctx_, "Cannot acquire more than 1 command buffer simultaneously");
+  LVK_ASSERT_MSG(isRenderThread(), "Command buffers can be acquired only on the thread which created the context");
+
+  flushPendingUploads();
 
   pimpl_->currentCommandBuffer_ = CommandBuffer(this);
 
@@ -2916,27 +4471,52 @@ lvk::SubmitHandle lvk::VulkanContext::submit(lvk::ICommandBuffer& commandBuffer,
 
     LVK_ASSERT(tex.isSwapchainImage_);
 
+    // virtual swapchain images are never presented, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR requires VK_KHR_swapchain
+    const bool isVirtual = hasSwapchain() && swapchain_->isVirtual();
+
     // prepare image for presentation the image might be coming from a compute shader
     const VkPipelineStageFlagBits srcStage = (tex.vkImageLayout_ == VK_IMAGE_LAYOUT_GENERAL)
                                                  ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
                                                  : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    tex.transitionLayout(vkCmdBuffer->wrapper_->cmdBuf_,
-                         VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+    tex.transitionLayout(vkCmdBuffer->barriers_,
+                         isVirtual ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
                          srcStage,
-                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // wait for all subsequent operations
+                         isVirtual ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
                          VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+
+    if (isVirtual) {
+      vkCmdBuffer->flushBarriers();
+      swapchain_->recordReadback(vkCmdBuffer->wrapper_->cmdBuf_, vkCmdBuffer->barriers_, tex);
+    }
   }
 
+  // barriers recorded after the last draw, dispatch or copy
+  vkCmdBuffer->flushBarriers();
+
   const bool shouldPresent = hasSwapchain() && present;
 
+  if (transientAllocator_) {
+    transientAllocator_->flush();
+  }
+
+  // uploads requested from other threads while this command buffer was being recorded go before it
+  flushPendingUploads();
+
   vkCmdBuffer->lastSubmitHandle_ = immediate_->submit(*vkCmdBuffer->wrapper_);
 
+  if (transientAllocator_) {
+    transientAllocator_->endFrame(vkCmdBuffer->lastSubmitHandle_);
+  }
+
   if (shouldPresent) {
-    swapchain_->present(immediate_->acquireLastSubmitSemaphore());
+    // a virtual swapchain does not wait on the semaphore, it stays chained to the next submit
+    swapchain_->present(swapchain_->isVirtual() ? VK_NULL_HANDLE : immediate_->acquireLastSubmitSemaphore());
   }
 
   processDeferredTasks();
 
+  checkMemoryBudget();
+
   SubmitHandle handle = vkCmdBuffer->lastSubmitHandle_;
 
   // reset
@@ -2949,6 +4529,29 @@ void lvk::VulkanContext::wait(SubmitHandle handle) {
   immediate_->wait(handle);
 }
 
+uint32_t lvk::VulkanContext::beginFrame() {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_WAIT);
+
+  LVK_ASSERT_MSG(!isInsideFrame_, "Did you forget to call endFrame()?");
+
+  isInsideFrame_ = true;
+
+  // the CPU cannot get more than `numFramesInFlight_` frames ahead of the GPU
+  immediate_->wait(frameSubmitHandles_[frameIndex_]);
+  frameSubmitHandles_[frameIndex_] = {};
+
+  return frameIndex_;
+}
+
+void lvk::VulkanContext::endFrame(SubmitHandle handle) {
+  LVK_ASSERT_MSG(isInsideFrame_, "Did you forget to call beginFrame()?");
+
+  isInsideFrame_ = false;
+
+  frameSubmitHandles_[frameIndex_] = handle.empty() ? immediate_->getLastSubmitHandle() : handle;
+  frameIndex_ = (frameIndex_ + 1) % numFramesInFlight_;
+}
+
 lvk::Holder<lvk::BufferHandle> lvk::VulkanContext::createBuffer(const BufferDesc& requestedDesc, Result* outResult) {
   BufferDesc desc = requestedDesc;
 
@@ -2985,8 +4588,12 @@ lvk::Holder<lvk::BufferHandle> lvk::VulkanContext::createBuffer(const BufferDesc
 
   const VkMemoryPropertyFlags memFlags = storageTypeToVkMemoryPropertyFlags(desc.storage);
 
+  // large buffers gain nothing from sharing a backing buffer
+  const bool suballocate = desc.suballocate && desc.size <= kMaxSuballocationSize;
+
   Result result;
-  BufferHandle handle = createBuffer(desc.size, usageFlags, memFlags, &result, desc.debugName);
+  BufferHandle handle = suballocate ? createSuballocatedBuffer(desc.size, usageFlags, memFlags, &result, desc.debugName)
+                                    : createBuffer(desc.size, usageFlags, memFlags, &result, desc.debugName);
 
   if (!LVK_VERIFY(result.isOk())) {
     Result::setResult(outResult, result);
@@ -3005,6 +4612,8 @@ lvk::Holder<lvk::BufferHandle> lvk::VulkanContext::createBuffer(const BufferDesc
 lvk::Holder<lvk::QueryPoolHandle> lvk::VulkanContext::createQueryPool(uint32_t numQueries, const char* debugName, Result* outResult) {
   LVK_PROFILER_FUNCTION();
 
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   const VkQueryPoolCreateInfo createInfo = {
       .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
       .flags = 0,
@@ -3021,13 +4630,138 @@ lvk::Holder<lvk::QueryPoolHandle> lvk::VulkanContext::createQueryPool(uint32_t n
     return {};
   }
 
-  if (debugName && *debugName) {
-    lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_QUERY_POOL, (uint64_t)queryPool, debugName);
+  if (debugName && *debugName) {
+    lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_QUERY_POOL, (uint64_t)queryPool, debugName);
+  }
+
+  lvk::QueryPoolHandle handle = queriesPool_.create(std::move(queryPool));
+
+  return {this, handle};
+}
+
+lvk::Holder<lvk::CommandBundleHandle> lvk::VulkanContext::createCommandBundle(const CommandBundleDesc& desc, Result* outResult) {
+  LVK_PROFILER_FUNCTION();
+
+  LVK_ASSERT_MSG(isRenderThread(), "Command bundles can be created only on the render thread");
+
+  if (!desc.record) {
+    Result::setResult(outResult, Result(Result::Code::ArgumentOutOfRange, "CommandBundleDesc::record is empty"));
+    return {};
+  }
+
+  if (bundlesCommandPool_ == VK_NULL_HANDLE) {
+    const VkCommandPoolCreateInfo ci = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = 0,
+        .queueFamilyIndex = deviceQueues_.graphicsQueueFamilyIndex,
+    };
+    VK_ASSERT(vkCreateCommandPool(vkDevice_, &ci, nullptr, &bundlesCommandPool_));
+    if (!bundlesCommandPool_) {
+      Result::setResult(outResult, Result(Result::Code::RuntimeError, "Cannot create VkCommandPool"));
+      return {};
+    }
+    lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_COMMAND_POOL, (uint64_t)bundlesCommandPool_, "Command Pool: bundles");
+  }
+
+  // the bundle binds the current descriptor set
+  checkAndUpdateDescriptorSets();
+
+  lvk::CommandBundleHandle handle;
+  {
+    std::lock_guard lock(pimpl_->resourcesMutex_);
+    handle = commandBundlesPool_.create(lvk::CommandBundleState{.desc_ = desc});
+  }
+
+  const Result result = updateCommandBundle(*commandBundlesPool_.get(handle), true);
+
+  if (!result.isOk()) {
+    destroy(handle);
+    Result::setResult(outResult, result);
+    return {};
+  }
+
+  Result::setResult(outResult, result);
+
+  return {this, handle};
+}
+
+lvk::Result lvk::VulkanContext::updateCommandBundle(CommandBundleState& bundle, bool force) {
+  if (!force) {
+    bool isValid = bundle.lastVkDescriptorSet_ == vkDSet_;
+    for (const auto& p : bundle.pipelines_) {
+      isValid = isValid && renderPipelinesPool_.isAlive(p.first) && getVkPipeline(p.first) == p.second;
+    }
+    if (isValid) {
+      return Result();
+    }
+  }
+
+  LVK_PROFILER_FUNCTION();
+
+  // the GPU can still be executing the previous command buffer
+  retire(RetiredObjectType_CommandBuffer, (uint64_t)bundle.wrapper_.cmdBuf_, (uint64_t)bundlesCommandPool_);
+  bundle.wrapper_.cmdBuf_ = VK_NULL_HANDLE;
+
+  const VkCommandBufferAllocateInfo ai = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool = bundlesCommandPool_,
+      .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+      .commandBufferCount = 1,
+  };
+  VK_ASSERT_RETURN(vkAllocateCommandBuffers(vkDevice_, &ai, &bundle.wrapper_.cmdBuf_));
+
+  if (bundle.desc_.debugName && *bundle.desc_.debugName) {
+    lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_COMMAND_BUFFER, (uint64_t)bundle.wrapper_.cmdBuf_, bundle.desc_.debugName);
+  }
+
+  const CommandBundleDesc& desc = bundle.desc_;
+
+  VkFormat colorFormats[LVK_MAX_COLOR_ATTACHMENTS] = {};
+  uint32_t numColorAttachments = 0;
+  while (numColorAttachments < LVK_MAX_COLOR_ATTACHMENTS && desc.color[numColorAttachments] != Format_Invalid) {
+    colorFormats[numColorAttachments] = formatToVkFormat(desc.color[numColorAttachments]);
+    numColorAttachments++;
+  }
+
+  const VkCommandBufferInheritanceRenderingInfo renderingInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+      .flags = 0,
+      .viewMask = 0,
+      .colorAttachmentCount = numColorAttachments,
+      .pColorAttachmentFormats = colorFormats,
+      .depthAttachmentFormat = formatToVkFormat(desc.depthFormat),
+      .stencilAttachmentFormat = formatToVkFormat(desc.stencilFormat),
+      .rasterizationSamples = lvk::getVulkanSampleCountFlags(desc.samplesCount),
+  };
+  const VkCommandBufferInheritanceInfo inheritanceInfo = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+      .pNext = &renderingInfo,
+  };
+  const VkCommandBufferBeginInfo bi = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      // executed every frame while the previous frames are still in flight
+      .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+      .pInheritanceInfo = &inheritanceInfo,
+  };
+  VK_ASSERT_RETURN(vkBeginCommandBuffer(bundle.wrapper_.cmdBuf_, &bi));
+
+  bundle.lastVkDescriptorSet_ = vkDSet_;
+  bundle.pipelines_.clear();
+
+  {
+    lvk::CommandBuffer buffer(this, &bundle);
+    buffer.resetRenderingState();
+    if (desc.width && desc.height) {
+      buffer.cmdBindViewport({0.0f, 0.0f, (float)desc.width, (float)desc.height, 0.0f, +1.0f});
+      buffer.cmdBindScissorRect({0, 0, desc.width, desc.height});
+    }
+    desc.record(buffer);
+    buffer.isRendering_ = false;
   }
 
-  lvk::QueryPoolHandle handle = queriesPool_.create(std::move(queryPool));
+  VK_ASSERT_RETURN(vkEndCommandBuffer(bundle.wrapper_.cmdBuf_));
 
-  return {this, handle};
+  return Result();
 }
 
 lvk::Holder<lvk::SamplerHandle> lvk::VulkanContext::createSampler(const SamplerStateDesc& desc, Result* outResult) {
@@ -3051,8 +4785,17 @@ lvk::Holder<lvk::SamplerHandle> lvk::VulkanContext::createSampler(const SamplerS
 lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureDesc& requestedDesc,
                                                                   const char* debugName,
                                                                   Result* outResult) {
+  return createTextureImpl(requestedDesc, debugName, outResult, nullptr);
+}
+
+lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTextureImpl(const TextureDesc& requestedDesc,
+                                                                      const char* debugName,
+                                                                      Result* outResult,
+                                                                      TextureAliasing* aliasing) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
 
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   TextureDesc desc(requestedDesc);
 
   if (debugName && *debugName) {
@@ -3101,6 +4844,19 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
     desc.usage = lvk::TextureUsageBits_Sampled;
   }
 
+  const bool isTransient = (desc.usage & lvk::TextureUsageBits_Transient) != 0;
+
+  if (isTransient) {
+    const bool isAttachmentOnly = (desc.usage & lvk::TextureUsageBits_Attachment) &&
+                                  !(desc.usage & (lvk::TextureUsageBits_Sampled | lvk::TextureUsageBits_Storage));
+    if (!LVK_VERIFY(isAttachmentOnly && !desc.data && desc.numMipLevels == 1)) {
+      Result::setResult(outResult,
+                        Result::Code::ArgumentOutOfRange,
+                        "Transient textures can only be single mip-level attachments without initial data");
+      return {};
+    }
+  }
+
   /* Use staging device to transfer data into the image when the storage is private to the device */
   VkImageUsageFlags usageFlags = (desc.storage == StorageType_Device) ? VK_IMAGE_USAGE_TRANSFER_DST_BIT : 0;
 
@@ -3119,9 +4875,18 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
   // For now, always set this flag so we can read it back
   usageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
+  if (isTransient) {
+    // VUID-VkImageCreateInfo-usage-00963: only attachment usages can be combined with TRANSIENT_ATTACHMENT
+    usageFlags = (usageFlags & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) |
+                 VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+  }
+
   LVK_ASSERT_MSG(usageFlags != 0, "Invalid usage flags");
 
-  const VkMemoryPropertyFlags memFlags = storageTypeToVkMemoryPropertyFlags(desc.storage);
+  const VkMemoryPropertyFlags memFlags = isTransient ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | (hasLazilyAllocatedMemory_
+                                                                                                  ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT
+                                                                                                  : 0)
+                                                     : storageTypeToVkMemoryPropertyFlags(desc.storage);
 
   const bool hasDebugName = desc.debugName && *desc.debugName;
 
@@ -3186,6 +4951,12 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
       .isStencilFormat_ = VulkanImage::isStencilFormat(vkFormat),
   };
 
+  VulkanImageMetadata metadata;
+
+  if (hasDebugName) {
+    snprintf(metadata.debugName_, sizeof(metadata.debugName_), "%s", desc.debugName);
+  }
+
   const VkImageCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
       .pNext = nullptr,
@@ -3204,12 +4975,37 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
       .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
   };
 
-  if (LVK_VULKAN_USE_VMA) {
+  if (aliasing && !aliasing->memory) {
+    // the first pass of createAliasedTextures() only needs the memory requirements
+    const VkDeviceImageMemoryRequirements info = {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+        .pCreateInfo = &ci,
+    };
+    VkMemoryRequirements2 requirements = {.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2};
+    vkGetDeviceImageMemoryRequirements(vkDevice_, &info, &requirements);
+    aliasing->requirements = requirements.memoryRequirements;
+    Result::setResult(outResult, Result());
+    return {};
+  }
+
+  if (aliasing) {
+    VK_ASSERT(vkCreateImage(vkDevice_, &ci, nullptr, &image.vkImage_));
+
+    if (LVK_VULKAN_USE_VMA) {
+      VK_ASSERT(vmaBindImageMemory2(aliasing->memory->vma_, aliasing->memory->vmaAllocation_, aliasing->offset, image.vkImage_, nullptr));
+    } else {
+      VK_ASSERT(vkBindImageMemory(vkDevice_, image.vkImage_, aliasing->memory->vkMemory_, aliasing->offset));
+    }
+
+    metadata.aliasedMemory_ = aliasing->memory;
+  } else if (LVK_VULKAN_USE_VMA) {
     VmaAllocationCreateInfo vmaAllocInfo = {
         .usage = memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ? VMA_MEMORY_USAGE_CPU_TO_GPU : VMA_MEMORY_USAGE_AUTO,
+        .preferredFlags = memFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
     };
 
-    VkResult result = vmaCreateImage((VmaAllocator)getVmaAllocator(), &ci, &vmaAllocInfo, &image.vkImage_, &image.vmaAllocation_, nullptr);
+    VkResult result =
+        vmaCreateImage((VmaAllocator)getVmaAllocator(), &ci, &vmaAllocInfo, &image.vkImage_, &metadata.vmaAllocation_, nullptr);
 
     if (!LVK_VERIFY(result == VK_SUCCESS)) {
       LLOGW("Failed: error result: %d, memflags: %d,  imageformat: %d\n", result, memFlags, image.vkImageFormat_);
@@ -3219,7 +5015,7 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
 
     // handle memory-mapped buffers
     if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-      vmaMapMemory((VmaAllocator)getVmaAllocator(), image.vmaAllocation_, &image.mappedPtr_);
+      vmaMapMemory((VmaAllocator)getVmaAllocator(), metadata.vmaAllocation_, &metadata.mappedPtr_);
     }
   } else {
     // create image
@@ -3230,20 +5026,20 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
       VkMemoryRequirements memRequirements = {};
       vkGetImageMemoryRequirements(vkDevice_, image.vkImage_, &memRequirements);
 
-      VK_ASSERT(lvk::allocateMemory(vkPhysicalDevice_, vkDevice_, &memRequirements, memFlags, &image.vkMemory_));
-      VK_ASSERT(vkBindImageMemory(vkDevice_, image.vkImage_, image.vkMemory_, 0));
+      VK_ASSERT(lvk::allocateMemory(vkPhysicalDevice_, vkDevice_, &memRequirements, memFlags, &metadata.vkMemory_));
+      VK_ASSERT(vkBindImageMemory(vkDevice_, image.vkImage_, metadata.vkMemory_, 0));
     }
 
     // handle memory-mapped images
     if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-      VK_ASSERT(vkMapMemory(vkDevice_, image.vkMemory_, 0, VK_WHOLE_SIZE, 0, &image.mappedPtr_));
+      VK_ASSERT(vkMapMemory(vkDevice_, metadata.vkMemory_, 0, VK_WHOLE_SIZE, 0, &metadata.mappedPtr_));
     }
   }
 
   VK_ASSERT(lvk::setDebugObjectName(vkDevice_, VK_OBJECT_TYPE_IMAGE, (uint64_t)image.vkImage_, debugNameImage));
 
   // Get physical device's properties for the image's format
-  vkGetPhysicalDeviceFormatProperties(vkPhysicalDevice_, image.vkImageFormat_, &image.vkFormatProperties_);
+  vkGetPhysicalDeviceFormatProperties(vkPhysicalDevice_, image.vkImageFormat_, &metadata.vkFormatProperties_);
 
   VkImageAspectFlags aspect = 0;
   if (image.isDepthFormat_ || image.isStencilFormat_) {
@@ -3271,7 +5067,8 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
     return {};
   }
 
-  TextureHandle handle = texturesPool_.create(std::move(image));
+  TextureHandle handle = texturesPool_.create(std::move(image), std::move(metadata));
+  texturesPool_.get(handle)->metadata_ = texturesPool_.getCold(handle);
 
   awaitingCreation_ = true;
 
@@ -3291,6 +5088,133 @@ lvk::Holder<lvk::TextureHandle> lvk::VulkanContext::createTexture(const TextureD
   return {this, handle};
 }
 
+lvk::Result lvk::VulkanContext::createAliasedTextures(const AliasedTextureDesc* descs,
+                                                     uint32_t numTextures,
+                                                     Holder<TextureHandle>* outTextures,
+                                                     const char* debugName) {
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
+
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
+  if (!LVK_VERIFY(descs && outTextures && numTextures)) {
+    return Result(Result::Code::ArgumentOutOfRange, "No textures to create");
+  }
+
+  std::vector<TextureAliasing> aliasing(numTextures);
+
+  uint32_t memoryTypeBits = ~0u;
+  VkDeviceSize alignment = 1;
+  bool allTransient = true;
+
+  // 1. collect memory requirements of all images
+  for (uint32_t i = 0; i != numTextures; i++) {
+    const AliasedTextureDesc& d = descs[i];
+    if (!LVK_VERIFY(d.firstUse <= d.lastUse && d.desc.storage == StorageType_Device && !d.desc.data)) {
+      return Result(Result::Code::ArgumentOutOfRange, "Aliased textures should have valid lifetimes, device storage and no initial data");
+    }
+    Result result;
+    (void)createTextureImpl(d.desc, nullptr, &result, &aliasing[i]);
+    if (!result.isOk()) {
+      return result;
+    }
+    memoryTypeBits &= aliasing[i].requirements.memoryTypeBits;
+    alignment = std::max(alignment, aliasing[i].requirements.alignment);
+    allTransient = allTransient && (d.desc.usage & TextureUsageBits_Transient);
+  }
+
+  if (!LVK_VERIFY(memoryTypeBits)) {
+    return Result(Result::Code::RuntimeError, "Textures have no common memory type and cannot be aliased");
+  }
+
+  // 2. place the largest images first, each at the lowest offset not intersecting any placed image with an overlapping lifetime
+  std::vector<uint32_t> order(numTextures);
+  for (uint32_t i = 0; i != numTextures; i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&aliasing](uint32_t a, uint32_t b) {
+    return aliasing[a].requirements.size > aliasing[b].requirements.size;
+  });
+
+  VkDeviceSize memorySize = 0;
+
+  for (uint32_t n = 0; n != numTextures; n++) {
+    const uint32_t i = order[n];
+    const VkMemoryRequirements& req = aliasing[i].requirements;
+    VkDeviceSize offset = 0;
+    // offsets only grow, so this converges
+    for (bool moved = true; moved;) {
+      moved = false;
+      for (uint32_t m = 0; m != n; m++) {
+        const uint32_t j = order[m];
+        const bool overlapInTime = descs[i].firstUse <= descs[j].lastUse && descs[j].firstUse <= descs[i].lastUse;
+        const VkDeviceSize end = aliasing[j].offset + aliasing[j].requirements.size;
+        if (overlapInTime && offset < end && aliasing[j].offset < offset + req.size) {
+          offset = (end + req.alignment - 1) / req.alignment * req.alignment;
+          moved = true;
+        }
+      }
+    }
+    aliasing[i].offset = offset;
+    memorySize = std::max(memorySize, offset + req.size);
+  }
+
+  // 3. allocate shared memory
+  auto memory = std::make_shared<VulkanAliasedMemory>();
+
+  memory->device_ = vkDevice_;
+  memory->vma_ = pimpl_->vma_;
+  memory->size_ = memorySize;
+  if (debugName) {
+    snprintf(memory->debugName_, sizeof(memory->debugName_), "%s", debugName);
+  }
+
+  const VkMemoryRequirements requirements = {
+      .size = memorySize,
+      .alignment = alignment,
+      .memoryTypeBits = memoryTypeBits,
+  };
+
+  // the same memory a single transient texture would get, see createTextureImpl()
+  const VkMemoryPropertyFlags memFlags =
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | (allTransient && hasLazilyAllocatedMemory_ ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : 0);
+
+  if (LVK_VULKAN_USE_VMA) {
+    const VmaAllocationCreateInfo ci = {
+        .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .preferredFlags = memFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+    };
+    const VkResult result = vmaAllocateMemory(pimpl_->vma_, &requirements, &ci, &memory->vmaAllocation_, nullptr);
+    if (!LVK_VERIFY(result == VK_SUCCESS)) {
+      return getResultFromVkResult(result);
+    }
+  } else {
+    VK_ASSERT_RETURN(lvk::allocateMemory(vkPhysicalDevice_, vkDevice_, &requirements, memFlags, &memory->vkMemory_));
+  }
+
+  // 4. create and bind the images
+  for (uint32_t i = 0; i != numTextures; i++) {
+    aliasing[i].memory = memory;
+    Result result;
+    outTextures[i] = createTextureImpl(descs[i].desc, nullptr, &result, &aliasing[i]);
+    if (!result.isOk()) {
+      for (uint32_t j = 0; j != i; j++) {
+        outTextures[j] = nullptr;
+      }
+      return result;
+    }
+  }
+
+  return Result();
+}
+
+lvk::VulkanAliasedMemory::~VulkanAliasedMemory() {
+  if (LVK_VULKAN_USE_VMA) {
+    vmaFreeMemory(vma_, vmaAllocation_);
+  } else {
+    vkFreeMemory(device_, vkMemory_, nullptr);
+  }
+}
+
 VkPipeline lvk::VulkanContext::getVkPipeline(RenderPipelineHandle handle) {
   lvk::RenderPipelineState* rps = renderPipelinesPool_.get(handle);
 
@@ -3299,10 +5223,8 @@ VkPipeline lvk::VulkanContext::getVkPipeline(RenderPipelineHandle handle) {
   }
 
   if (rps->lastVkDescriptorSetLayout_ != vkDSL_) {
-    deferredTask(std::packaged_task<void()>(
-        [device = getVkDevice(), pipeline = rps->pipeline_]() { vkDestroyPipeline(device, pipeline, nullptr); }));
-    deferredTask(std::packaged_task<void()>(
-        [device = getVkDevice(), layout = rps->pipelineLayout_]() { vkDestroyPipelineLayout(device, layout, nullptr); }));
+    retire(RetiredObjectType_Pipeline, (uint64_t)rps->pipeline_);
+    retire(RetiredObjectType_PipelineLayout, (uint64_t)rps->pipelineLayout_);
     rps->pipeline_ = VK_NULL_HANDLE;
     rps->lastVkDescriptorSetLayout_ = vkDSL_;
   }
@@ -3488,10 +5410,8 @@ VkPipeline lvk::VulkanContext::getVkPipeline(ComputePipelineHandle handle) {
   }
 
   if (cps->lastVkDescriptorSetLayout_ != vkDSL_) {
-    deferredTask(
-        std::packaged_task<void()>([device = vkDevice_, pipeline = cps->pipeline_]() { vkDestroyPipeline(device, pipeline, nullptr); }));
-    deferredTask(std::packaged_task<void()>(
-        [device = vkDevice_, layout = cps->pipelineLayout_]() { vkDestroyPipelineLayout(device, layout, nullptr); }));
+    retire(RetiredObjectType_Pipeline, (uint64_t)cps->pipeline_);
+    retire(RetiredObjectType_PipelineLayout, (uint64_t)cps->pipelineLayout_);
     cps->pipeline_ = VK_NULL_HANDLE;
     cps->pipelineLayout_ = VK_NULL_HANDLE;
     cps->lastVkDescriptorSetLayout_ = vkDSL_;
@@ -3547,6 +5467,8 @@ VkPipeline lvk::VulkanContext::getVkPipeline(ComputePipelineHandle handle) {
 }
 
 lvk::Holder<lvk::ComputePipelineHandle> lvk::VulkanContext::createComputePipeline(const ComputePipelineDesc& desc, Result* outResult) {
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   if (!LVK_VERIFY(desc.smComp.valid())) {
     Result::setResult(outResult, Result::Code::ArgumentOutOfRange, "Missing compute shader");
     return {};
@@ -3556,6 +5478,8 @@ lvk::Holder<lvk::ComputePipelineHandle> lvk::VulkanContext::createComputePipelin
 }
 
 lvk::Holder<lvk::RenderPipelineHandle> lvk::VulkanContext::createRenderPipeline(const RenderPipelineDesc& desc, Result* outResult) {
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   const bool hasColorAttachments = desc.getNumColorAttachments() > 0;
   const bool hasDepthAttachment = desc.depthFormat != Format_Invalid;
   const bool hasAnyAttachments = hasColorAttachments || hasDepthAttachment;
@@ -3600,36 +5524,38 @@ lvk::Holder<lvk::RenderPipelineHandle> lvk::VulkanContext::createRenderPipeline(
 }
 
 void lvk::VulkanContext::destroy(lvk::ComputePipelineHandle handle) {
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   lvk::ComputePipelineState* cps = computePipelinesPool_.get(handle);
 
   if (!cps) {
     return;
   }
 
-  deferredTask(
-      std::packaged_task<void()>([device = getVkDevice(), pipeline = cps->pipeline_]() { vkDestroyPipeline(device, pipeline, nullptr); }));
-  deferredTask(std::packaged_task<void()>(
-      [device = getVkDevice(), layout = cps->pipelineLayout_]() { vkDestroyPipelineLayout(device, layout, nullptr); }));
+  retire(RetiredObjectType_Pipeline, (uint64_t)cps->pipeline_);
+  retire(RetiredObjectType_PipelineLayout, (uint64_t)cps->pipelineLayout_);
 
   computePipelinesPool_.destroy(handle);
 }
 
 void lvk::VulkanContext::destroy(lvk::RenderPipelineHandle handle) {
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   lvk::RenderPipelineState* rps = renderPipelinesPool_.get(handle);
 
   if (!rps) {
     return;
   }
 
-  deferredTask(
-      std::packaged_task<void()>([device = getVkDevice(), pipeline = rps->pipeline_]() { vkDestroyPipeline(device, pipeline, nullptr); }));
-  deferredTask(std::packaged_task<void()>(
-      [device = getVkDevice(), layout = rps->pipelineLayout_]() { vkDestroyPipelineLayout(device, layout, nullptr); }));
+  retire(RetiredObjectType_Pipeline, (uint64_t)rps->pipeline_);
+  retire(RetiredObjectType_PipelineLayout, (uint64_t)rps->pipelineLayout_);
 
   renderPipelinesPool_.destroy(handle);
 }
 
 void lvk::VulkanContext::destroy(lvk::ShaderModuleHandle handle) {
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   const lvk::ShaderModuleState* state = shaderModulesPool_.get(handle);
 
   if (!state) {
@@ -3648,16 +5574,20 @@ void lvk::VulkanContext::destroy(lvk::ShaderModuleHandle handle) {
 void lvk::VulkanContext::destroy(SamplerHandle handle) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_DESTROY);
 
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   VkSampler sampler = *samplersPool_.get(handle);
 
   samplersPool_.destroy(handle);
 
-  deferredTask(std::packaged_task<void()>([device = vkDevice_, sampler = sampler]() { vkDestroySampler(device, sampler, nullptr); }));
+  retire(RetiredObjectType_Sampler, (uint64_t)sampler);
 }
 
 void lvk::VulkanContext::destroy(BufferHandle handle) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_DESTROY);
 
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   SCOPE_EXIT {
     buffersPool_.destroy(handle);
   };
@@ -3668,27 +5598,32 @@ void lvk::VulkanContext::destroy(BufferHandle handle) {
     return;
   }
 
+  const VulkanBufferMetadata* metadata = buffersPool_.getCold(handle);
+
+  if (buf->isSuballocated()) {
+    // the backing buffer stays alive, only return the range to its block once the GPU is done with it
+    retire(RetiredObjectType_VirtualAllocation, (uint64_t)metadata->vmaVirtualBlock_, (uint64_t)metadata->vmaVirtualAllocation_);
+    return;
+  }
+
   if (LVK_VULKAN_USE_VMA) {
     if (buf->mappedPtr_) {
-      vmaUnmapMemory((VmaAllocator)getVmaAllocator(), buf->vmaAllocation_);
+      vmaUnmapMemory((VmaAllocator)getVmaAllocator(), metadata->vmaAllocation_);
     }
-    deferredTask(std::packaged_task<void()>([vma = getVmaAllocator(), buffer = buf->vkBuffer_, allocation = buf->vmaAllocation_]() {
-      vmaDestroyBuffer((VmaAllocator)vma, buffer, allocation);
-    }));
+    retire(RetiredObjectType_BufferVma, (uint64_t)buf->vkBuffer_, (uint64_t)metadata->vmaAllocation_);
   } else {
     if (buf->mappedPtr_) {
-      vkUnmapMemory(vkDevice_, buf->vkMemory_);
+      vkUnmapMemory(vkDevice_, metadata->vkMemory_);
     }
-    deferredTask(std::packaged_task<void()>([device = vkDevice_, buffer = buf->vkBuffer_, memory = buf->vkMemory_]() {
-      vkDestroyBuffer(device, buffer, nullptr);
-      vkFreeMemory(device, memory, nullptr);
-    }));
+    retire(RetiredObjectType_Buffer, (uint64_t)buf->vkBuffer_, (uint64_t)metadata->vkMemory_);
   }
 }
 
 void lvk::VulkanContext::destroy(lvk::TextureHandle handle) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_DESTROY);
 
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   SCOPE_EXIT {
     texturesPool_.destroy(handle);
   };
@@ -3699,49 +5634,62 @@ void lvk::VulkanContext::destroy(lvk::TextureHandle handle) {
     return;
   }
 
-  deferredTask(std::packaged_task<void()>(
-      [device = getVkDevice(), imageView = tex->imageView_]() { vkDestroyImageView(device, imageView, nullptr); }));
+  const VulkanImageMetadata* metadata = texturesPool_.getCold(handle);
 
-  for (size_t i = 0; i != LVK_MAX_MIP_LEVELS; i++) {
-    for (size_t j = 0; j != LVK_ARRAY_NUM_ELEMENTS(tex->imageViewForFramebuffer_[0]); j++) {
-      VkImageView v = tex->imageViewForFramebuffer_[i][j];
-      if (v != VK_NULL_HANDLE) {
-        deferredTask(
-            std::packaged_task<void()>([device = getVkDevice(), imageView = v]() { vkDestroyImageView(device, imageView, nullptr); }));
-      }
-    }
+  retire(RetiredObjectType_ImageView, (uint64_t)tex->imageView_);
+
+  for (const VulkanImageMetadata::FramebufferView& v : metadata->framebufferViews_) {
+    retire(RetiredObjectType_ImageView, (uint64_t)v.view);
   }
 
   if (tex->isSwapchainImage_) {
     return;
   }
 
+  if (metadata->aliasedMemory_) {
+    // the shared memory is released together with the last image referencing it
+    deferredTask(std::packaged_task<void()>([device = vkDevice_, image = tex->vkImage_, memory = metadata->aliasedMemory_]() mutable {
+      vkDestroyImage(device, image, nullptr);
+      memory.reset();
+    }));
+    return;
+  }
+
   if (LVK_VULKAN_USE_VMA) {
-    if (tex->mappedPtr_) {
-      vmaUnmapMemory((VmaAllocator)getVmaAllocator(), tex->vmaAllocation_);
+    if (metadata->mappedPtr_) {
+      vmaUnmapMemory((VmaAllocator)getVmaAllocator(), metadata->vmaAllocation_);
     }
-    deferredTask(std::packaged_task<void()>([vma = getVmaAllocator(), image = tex->vkImage_, allocation = tex->vmaAllocation_]() {
-      vmaDestroyImage((VmaAllocator)vma, image, allocation);
-    }));
+    retire(RetiredObjectType_ImageVma, (uint64_t)tex->vkImage_, (uint64_t)metadata->vmaAllocation_);
   } else {
-    if (tex->mappedPtr_) {
-      vkUnmapMemory(vkDevice_, tex->vkMemory_);
+    if (metadata->mappedPtr_) {
+      vkUnmapMemory(vkDevice_, metadata->vkMemory_);
     }
-    deferredTask(std::packaged_task<void()>([device = vkDevice_, image = tex->vkImage_, memory = tex->vkMemory_]() {
-      vkDestroyImage(device, image, nullptr);
-      if (memory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, memory, nullptr);
-      }
-    }));
+    retire(RetiredObjectType_Image, (uint64_t)tex->vkImage_, (uint64_t)metadata->vkMemory_);
   }
 }
 
 void lvk::VulkanContext::destroy(lvk::QueryPoolHandle handle) {
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   VkQueryPool pool = *queriesPool_.get(handle);
 
   queriesPool_.destroy(handle);
 
-  deferredTask(std::packaged_task<void()>([device = vkDevice_, pool = pool]() { vkDestroyQueryPool(device, pool, nullptr); }));
+  retire(RetiredObjectType_QueryPool, (uint64_t)pool);
+}
+
+void lvk::VulkanContext::destroy(lvk::CommandBundleHandle handle) {
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
+  lvk::CommandBundleState* bundle = commandBundlesPool_.get(handle);
+
+  if (!bundle) {
+    return;
+  }
+
+  retire(RetiredObjectType_CommandBuffer, (uint64_t)bundle->wrapper_.cmdBuf_, (uint64_t)bundlesCommandPool_);
+
+  commandBundlesPool_.destroy(handle);
 }
 
 void lvk::VulkanContext::destroy(Framebuffer& fb) {
@@ -3784,6 +5732,13 @@ lvk::Result lvk::VulkanContext::upload(lvk::BufferHandle handle, const void* dat
     return lvk::Result(Result::Code::ArgumentOutOfRange, "Out of range");
   }
 
+  if (!isRenderThread() && !buf->isMapped()) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    std::lock_guard lock(pimpl_->pendingMutex_);
+    pimpl_->pendingUploads_.push_back({.buffer = handle, .offset = offset, .data = std::vector<uint8_t>(bytes, bytes + size)});
+    return lvk::Result();
+  }
+
   stagingDevice_->bufferSubData(*buf, offset, size, data);
 
   return lvk::Result();
@@ -3807,6 +5762,15 @@ uint64_t lvk::VulkanContext::gpuAddress(BufferHandle handle, size_t offset) cons
   return buf ? (uint64_t)buf->vkDeviceAddress_ + offset : 0u;
 }
 
+lvk::TransientAllocation lvk::VulkanContext::allocateTransient(size_t size, size_t alignment) {
+  if (!LVK_VERIFY(transientAllocator_)) {
+    LLOGW("Transient allocations are disabled: ContextConfig::transientBufferSize is 0\n");
+    return {};
+  }
+
+  return transientAllocator_->allocate(size, alignment);
+}
+
 void lvk::VulkanContext::flushMappedMemory(BufferHandle handle, size_t offset, size_t size) const {
   const lvk::VulkanBuffer* buf = buffersPool_.get(handle);
 
@@ -3815,7 +5779,103 @@ void lvk::VulkanContext::flushMappedMemory(BufferHandle handle, size_t offset, s
   buf->flushMappedMemory(*this, offset, size);
 }
 
+lvk::Result lvk::VulkanContext::uploadFromFile(BufferHandle handle,
+                                               const char* fileName,
+                                               size_t fileOffset,
+                                               size_t size,
+                                               size_t bufferOffset) {
+  LVK_PROFILER_FUNCTION();
+
+  lvk::VulkanBuffer* buf = buffersPool_.get(handle);
+
+  if (!LVK_VERIFY(buf)) {
+    return Result(Result::Code::ArgumentOutOfRange, "Invalid buffer handle");
+  }
+
+  MappedFileRegion file;
+
+  const Result result = file.map(fileName, fileOffset, size);
+
+  if (!result.isOk()) {
+    return result;
+  }
+
+  if (!LVK_VERIFY(bufferOffset + file.size() <= buf->bufferSize_)) {
+    return Result(Result::Code::ArgumentOutOfRange, "Out of range");
+  }
+
+  if (!isRenderThread() && !buf->isMapped()) {
+    std::lock_guard lock(pimpl_->pendingMutex_);
+    pimpl_->pendingUploads_.push_back({.buffer = handle, .offset = bufferOffset, .file = std::move(file)});
+    return Result();
+  }
+
+  // host-visible buffers are written directly from the mapped file; everything else is streamed through the staging buffer in chunks
+  stagingDevice_->bufferSubData(*buf, bufferOffset, file.size(), file.data());
+
+  return Result();
+}
+
+namespace {
+
+// the same amount of data VulkanStagingDevice is going to read
+size_t getTextureUploadSize(const lvk::VulkanImage& texture, const lvk::TextureRangeDesc& range) {
+  if (texture.vkType_ == VK_IMAGE_TYPE_3D) {
+    return (size_t)range.dimensions.width * range.dimensions.height * range.dimensions.depth *
+           lvk::getBytesPerPixel(texture.vkImageFormat_);
+  }
+
+  const lvk::Format format = lvk::vkFormatToFormat(texture.vkImageFormat_);
+
+  size_t storageSize = 0;
+
+  for (uint32_t i = 0; i != range.numMipLevels; i++) {
+    storageSize += lvk::getTextureBytesPerLayer(texture.vkExtent_.width, texture.vkExtent_.height, format, i);
+  }
+
+  return storageSize * std::max(range.numLayers, 1u);
+}
+
+} // namespace
+
+lvk::Result lvk::VulkanContext::uploadFromFile(TextureHandle handle,
+                                               const TextureRangeDesc& range,
+                                               const char* fileName,
+                                               size_t fileOffset) {
+  LVK_PROFILER_FUNCTION();
+
+  const lvk::VulkanImage* texture = texturesPool_.get(handle);
+
+  if (!LVK_VERIFY(texture)) {
+    return Result(Result::Code::ArgumentOutOfRange, "Invalid texture handle");
+  }
+
+  const Result result = validateRange(texture->vkExtent_, texture->numLevels_, range);
+
+  if (!LVK_VERIFY(result.isOk())) {
+    return result;
+  }
+
+  MappedFileRegion file;
+
+  const Result mapResult = file.map(fileName, fileOffset, getTextureUploadSize(*texture, range));
+
+  if (!mapResult.isOk()) {
+    return mapResult;
+  }
+
+  if (!isRenderThread()) {
+    std::lock_guard lock(pimpl_->pendingMutex_);
+    pimpl_->pendingUploads_.push_back({.texture = handle, .range = range, .file = std::move(file)});
+    return Result();
+  }
+
+  return upload(handle, range, file.data());
+}
+
 lvk::Result lvk::VulkanContext::download(lvk::TextureHandle handle, const TextureRangeDesc& range, void* outData) {
+  LVK_ASSERT_MSG(isRenderThread(), "Textures can be downloaded only on the thread which created the context");
+
   if (!outData) {
     return Result(Result::Code::ArgumentOutOfRange);
   }
@@ -3867,6 +5927,14 @@ lvk::Result lvk::VulkanContext::upload(lvk::TextureHandle handle, const TextureR
     return result;
   }
 
+  if (!isRenderThread()) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    std::lock_guard lock(pimpl_->pendingMutex_);
+    pimpl_->pendingUploads_.push_back(
+        {.texture = handle, .range = range, .data = std::vector<uint8_t>(bytes, bytes + getTextureUploadSize(*texture, range))});
+    return Result();
+  }
+
   const uint32_t numLayers = std::max(range.numLayers, 1u);
 
   VkFormat vkFormat = texture->vkImageFormat_;
@@ -3919,7 +5987,13 @@ void lvk::VulkanContext::generateMipmap(TextureHandle handle) const {
     return;
   }
 
-  LVK_ASSERT(tex->vkImageLayout_ != VK_IMAGE_LAYOUT_UNDEFINED);
+  if (!isRenderThread()) {
+    std::lock_guard lock(pimpl_->pendingMutex_);
+    pimpl_->pendingUploads_.push_back({.texture = handle, .generateMipmap = true});
+    return;
+  }
+
+  LVK_ASSERT(tex->getSubresourceLayout(0, 0) != VK_IMAGE_LAYOUT_UNDEFINED);
   const auto& wrapper = immediate_->acquire();
   tex->generateMipmap(wrapper.cmdBuf_);
   immediate_->submit(wrapper);
@@ -3933,6 +6007,27 @@ lvk::Format lvk::VulkanContext::getFormat(TextureHandle handle) const {
   return vkFormatToFormat(texturesPool_.get(handle)->vkImageFormat_);
 }
 
+uint8_t lvk::VulkanContext::getTextureUsage(TextureHandle handle) const {
+  const lvk::VulkanImage* tex = texturesPool_.get(handle);
+
+  if (!tex) {
+    return 0;
+  }
+
+  uint8_t usage = 0;
+
+  if (tex->vkUsageFlags_ & VK_IMAGE_USAGE_SAMPLED_BIT)
+    usage |= TextureUsageBits_Sampled;
+  if (tex->vkUsageFlags_ & VK_IMAGE_USAGE_STORAGE_BIT)
+    usage |= TextureUsageBits_Storage;
+  if (tex->vkUsageFlags_ & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))
+    usage |= TextureUsageBits_Attachment;
+  if (tex->vkUsageFlags_ & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+    usage |= TextureUsageBits_Transient;
+
+  return usage;
+}
+
 lvk::Holder<lvk::ShaderModuleHandle> lvk::VulkanContext::createShaderModule(const ShaderModuleDesc& desc, Result* outResult) {
   Result result;
   ShaderModuleState sm = desc.dataSize ? createShaderModuleFromSPIRV(desc.data, desc.dataSize, desc.debugName, &result) // binary
@@ -3944,6 +6039,8 @@ lvk::Holder<lvk::ShaderModuleHandle> lvk::VulkanContext::createShaderModule(cons
   }
   Result::setResult(outResult, result);
 
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   return {this, shaderModulesPool_.create(std::move(sm))};
 }
 
@@ -4098,41 +6195,198 @@ lvk::TextureHandle lvk::VulkanContext::getCurrentSwapchainTexture() {
 
   TextureHandle tex = swapchain_->getCurrentTexture();
 
-  if (!LVK_VERIFY(tex.valid())) {
-    LVK_ASSERT_MSG(false, "Swapchain has no valid texture");
-    return {};
+  if (!LVK_VERIFY(tex.valid())) {
+    LVK_ASSERT_MSG(false, "Swapchain has no valid texture");
+    return {};
+  }
+
+  LVK_ASSERT_MSG(texturesPool_.get(tex)->vkImageFormat_ != VK_FORMAT_UNDEFINED, "Invalid image format");
+
+  return tex;
+}
+
+void lvk::VulkanContext::recreateSwapchain(int newWidth, int newHeight) {
+  initSwapchain(newWidth, newHeight);
+}
+
+uint64_t lvk::VulkanContext::getLastPresentId() const {
+  return swapchain_ ? swapchain_->getLastPresentId() : 0;
+}
+
+bool lvk::VulkanContext::waitForPresent(uint64_t presentId, uint64_t timeoutNanoseconds) {
+  if (!swapchain_ || !presentId || (!hasPresentWait_ && !swapchain_->isVirtual())) {
+    return false;
+  }
+
+  return swapchain_->waitForPresent(presentId, timeoutNanoseconds);
+}
+
+uint64_t lvk::VulkanContext::readbackPresentedImage(void* outData, size_t sizeInBytes) {
+  LVK_ASSERT(outData);
+
+  if (!swapchain_ || !swapchain_->isVirtual()) {
+    return 0;
+  }
+
+  return swapchain_->readbackPresentedImage(outData, sizeInBytes);
+}
+
+uint32_t lvk::VulkanContext::getFramebufferMSAABitMask() const {
+  const VkPhysicalDeviceLimits& limits = getVkPhysicalDeviceProperties().limits;
+  return limits.framebufferColorSampleCounts;
+}
+
+double lvk::VulkanContext::getTimestampPeriodToMs() const {
+  return double(getVkPhysicalDeviceProperties().limits.timestampPeriod) * 1e-6;
+}
+
+bool lvk::VulkanContext::getQueryPoolResults(QueryPoolHandle pool,
+                                             uint32_t firstQuery,
+                                             uint32_t queryCount,
+                                             size_t dataSize,
+                                             void* outData,
+                                             size_t stride) const {
+  VkQueryPool vkPool = *queriesPool_.get(pool);
+
+  VK_ASSERT(vkGetQueryPoolResults(
+      vkDevice_, vkPool, firstQuery, queryCount, dataSize, outData, stride, VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT));
+
+  return true;
+}
+
+lvk::MemoryStats lvk::VulkanContext::getMemoryStats() const {
+  LVK_PROFILER_FUNCTION();
+
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
+  MemoryStats stats;
+
+  VkPhysicalDeviceMemoryProperties memProps = {};
+  vkGetPhysicalDeviceMemoryProperties(vkPhysicalDevice_, &memProps);
+
+  stats.numHeaps = std::min(memProps.memoryHeapCount, (uint32_t)MemoryStats::LVK_MAX_MEMORY_HEAPS);
+
+  VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+
+  if (LVK_VULKAN_USE_VMA) {
+    // VMA falls back to its own estimates when VK_EXT_memory_budget is not enabled
+    vmaGetHeapBudgets(pimpl_->vma_, budgets);
+  }
+
+  for (uint32_t i = 0; i != stats.numHeaps; i++) {
+    const VkMemoryHeap& heap = memProps.memoryHeaps[i];
+    stats.heaps[i] = {
+        .size = heap.size,
+        .budget = LVK_VULKAN_USE_VMA ? budgets[i].budget : heap.size,
+        .usage = LVK_VULKAN_USE_VMA ? budgets[i].usage : 0,
+        .isDeviceLocal = (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+    };
+  }
+
+  // keep the largest allocations sorted in descending order
+  auto addAllocation = [&stats](const char* debugName, uint64_t size, bool isTexture) {
+    uint32_t i = stats.numLargestAllocations;
+    if (i == MemoryStats::LVK_MAX_LARGEST_ALLOCATIONS) {
+      if (stats.largestAllocations[i - 1].size >= size) {
+        return;
+      }
+      i--;
+    } else {
+      stats.numLargestAllocations++;
+    }
+    for (; i > 0 && stats.largestAllocations[i - 1].size < size; i--) {
+      stats.largestAllocations[i] = stats.largestAllocations[i - 1];
+    }
+    MemoryAllocationStats& a = stats.largestAllocations[i];
+    a = {.size = size, .isTexture = isTexture};
+    snprintf(a.debugName, sizeof(a.debugName), "%s", debugName);
+  };
+
+  for (uint32_t i = 0; i != buffersPool_.numSlots(); i++) {
+    const VulkanBuffer& buf = buffersPool_.objectAt(i);
+    // skip free entries; sub-allocated buffers live inside their backing buffers which are counted here
+    if (buf.vkBuffer_ == VK_NULL_HANDLE || buf.isSuballocated()) {
+      continue;
+    }
+    stats.numBuffers++;
+    stats.buffersBytes += buf.bufferSize_;
+    addAllocation(buffersPool_.coldAt(i).debugName_, buf.bufferSize_, false);
   }
 
-  LVK_ASSERT_MSG(texturesPool_.get(tex)->vkImageFormat_ != VK_FORMAT_UNDEFINED, "Invalid image format");
-
-  return tex;
-}
+  std::vector<const VulkanAliasedMemory*> aliasedMemory;
 
-void lvk::VulkanContext::recreateSwapchain(int newWidth, int newHeight) {
-  initSwapchain(newWidth, newHeight);
-}
+  for (uint32_t i = 0; i != texturesPool_.numSlots(); i++) {
+    const VulkanImage& img = texturesPool_.objectAt(i);
+    const VulkanImageMetadata& metadata = texturesPool_.coldAt(i);
+    // skip free entries and swapchain images which are owned by the swapchain
+    if (img.vkImage_ == VK_NULL_HANDLE || img.isSwapchainImage_) {
+      continue;
+    }
+    if (metadata.aliasedMemory_) {
+      // account the shared memory only once
+      const VulkanAliasedMemory* mem = metadata.aliasedMemory_.get();
+      stats.numTextures++;
+      if (std::find(aliasedMemory.begin(), aliasedMemory.end(), mem) == aliasedMemory.end()) {
+        aliasedMemory.push_back(mem);
+        stats.texturesBytes += mem->size_;
+        addAllocation(mem->debugName_, mem->size_, true);
+      }
+      continue;
+    }
+    VkDeviceSize size = 0;
+    if (LVK_VULKAN_USE_VMA) {
+      VmaAllocationInfo info = {};
+      vmaGetAllocationInfo(pimpl_->vma_, metadata.vmaAllocation_, &info);
+      size = info.size;
+    } else {
+      VkMemoryRequirements memRequirements = {};
+      vkGetImageMemoryRequirements(vkDevice_, img.vkImage_, &memRequirements);
+      size = memRequirements.size;
+    }
+    stats.numTextures++;
+    stats.texturesBytes += size;
+    addAllocation(metadata.debugName_, size, true);
+  }
 
-uint32_t lvk::VulkanContext::getFramebufferMSAABitMask() const {
-  const VkPhysicalDeviceLimits& limits = getVkPhysicalDeviceProperties().limits;
-  return limits.framebufferColorSampleCounts;
-}
+  if (stagingDevice_) {
+    stagingDevice_->getMemoryUsage(stats.stagingBytes, stats.stagingBytesInUse);
+  }
 
-double lvk::VulkanContext::getTimestampPeriodToMs() const {
-  return double(getVkPhysicalDeviceProperties().limits.timestampPeriod) * 1e-6;
+  return stats;
 }
 
-bool lvk::VulkanContext::getQueryPoolResults(QueryPoolHandle pool,
-                                             uint32_t firstQuery,
-                                             uint32_t queryCount,
-                                             size_t dataSize,
-                                             void* outData,
-                                             size_t stride) const {
-  VkQueryPool vkPool = *queriesPool_.get(pool);
+void lvk::VulkanContext::checkMemoryBudget() {
+  // without VMA there is no usage tracking to compare against
+  if (!config_.memoryBudgetCallback || !LVK_VULKAN_USE_VMA) {
+    return;
+  }
 
-  VK_ASSERT(vkGetQueryPoolResults(
-      vkDevice_, vkPool, firstQuery, queryCount, dataSize, outData, stride, VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT));
+  LVK_PROFILER_FUNCTION();
 
-  return true;
+  // this runs on every submit, so only the heap budgets are queried here; getMemoryStats() walks all resources
+  VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+  vmaGetHeapBudgets(pimpl_->vma_, budgets);
+
+  const VkPhysicalDeviceMemoryProperties* memProps = nullptr;
+  vmaGetMemoryProperties(pimpl_->vma_, &memProps);
+
+  const uint32_t numHeaps = std::min(memProps->memoryHeapCount, (uint32_t)MemoryStats::LVK_MAX_MEMORY_HEAPS);
+
+  for (uint32_t i = 0; i != numHeaps; i++) {
+    const VmaBudget& budget = budgets[i];
+    const bool isAbove = budget.budget && double(budget.usage) > double(budget.budget) * config_.memoryBudgetThreshold;
+    // notify only when crossing the threshold upwards
+    if (isAbove && !pimpl_->isHeapAboveBudgetThreshold_[i]) {
+      const MemoryHeapStats heap = {
+          .size = memProps->memoryHeaps[i].size,
+          .budget = budget.budget,
+          .usage = budget.usage,
+          .isDeviceLocal = (memProps->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+      };
+      config_.memoryBudgetCallback(this, i, heap);
+    }
+    pimpl_->isHeapAboveBudgetThreshold_[i] = isAbove;
+  }
 }
 
 #ifdef LVK_WITH_OPENXR
@@ -4158,31 +6412,40 @@ void lvk::VulkanContext::createInstance(
 ) {
   vkInstance_ = VK_NULL_HANDLE;
 
-  const char* instanceExtensionNames[] = {
-    VK_KHR_SURFACE_EXTENSION_NAME,
+  std::vector<const char*> instanceExtensionNames = {
     VK_EXT_DEBUG_UTILS_EXTENSION_NAME,
+#if defined(__APPLE__)
+    VK_EXT_LAYER_SETTINGS_EXTENSION_NAME,
+#endif
+#if defined(LVK_WITH_VULKAN_PORTABILITY)
+    VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME,
+#endif
+  };
+
+  // headless contexts need no WSI, so they can run on drivers without any surface support (render servers, software ICDs)
+  if (!isHeadless_) {
+    const char* surfaceExtensionNames[] = {
+      VK_KHR_SURFACE_EXTENSION_NAME,
 #if defined(_WIN32)
-    VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
+      VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
 #elif defined(VK_USE_PLATFORM_ANDROID_KHR)
-    VK_KHR_ANDROID_SURFACE_EXTENSION_NAME,
+      VK_KHR_ANDROID_SURFACE_EXTENSION_NAME,
 #elif defined(__linux__)
 #if defined(VK_USE_PLATFORM_WAYLAND_KHR)
-    VK_KHR_WAYLAND_SURFACE_EXTENSION_NAME,
+      VK_KHR_WAYLAND_SURFACE_EXTENSION_NAME,
 #else
-    VK_KHR_XLIB_SURFACE_EXTENSION_NAME,
+      VK_KHR_XLIB_SURFACE_EXTENSION_NAME,
 #endif
 #elif defined(__APPLE__)
-    VK_EXT_LAYER_SETTINGS_EXTENSION_NAME,
-    VK_MVK_MACOS_SURFACE_EXTENSION_NAME,
+      VK_MVK_MACOS_SURFACE_EXTENSION_NAME,
 #endif
-#if defined(LVK_WITH_VULKAN_PORTABILITY)
-    VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME,
-#endif
-    VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME // enabled only for validation
-  };
+    };
+    instanceExtensionNames.insert(instanceExtensionNames.end(), std::begin(surfaceExtensionNames), std::end(surfaceExtensionNames));
+  }
 
-  const uint32_t numInstanceExtensions = config_.enableValidation ? (uint32_t)LVK_ARRAY_NUM_ELEMENTS(instanceExtensionNames)
-                                                                  : (uint32_t)LVK_ARRAY_NUM_ELEMENTS(instanceExtensionNames) - 1;
+  if (config_.enableValidation) {
+    instanceExtensionNames.push_back(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME);
+  }
 
 #if !defined(ANDROID)
   // GPU Assisted Validation doesn't work on Android.
@@ -4253,8 +6516,8 @@ void lvk::VulkanContext::createInstance(
     .pApplicationInfo = &appInfo,
     .enabledLayerCount = config_.enableValidation ? (uint32_t)LVK_ARRAY_NUM_ELEMENTS(kDefaultValidationLayers) : 0u,
     .ppEnabledLayerNames = config_.enableValidation ? kDefaultValidationLayers : nullptr,
-    .enabledExtensionCount = numInstanceExtensions,
-    .ppEnabledExtensionNames = instanceExtensionNames,
+    .enabledExtensionCount = (uint32_t)instanceExtensionNames.size(),
+    .ppEnabledExtensionNames = instanceExtensionNames.data(),
   };
 
 #ifdef LVK_WITH_OPENXR
@@ -4464,8 +6727,7 @@ lvk::Result lvk::VulkanContext::initContext(const HWDeviceDesc& desc
   };
   const uint32_t numQueues = ciQueue[0].queueFamilyIndex == ciQueue[1].queueFamilyIndex ? 1 : 2;
 
-  const char* deviceExtensionNames[] = {
-      VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+  std::vector<const char*> deviceExtensionNames = {
       VK_EXT_DEPTH_RANGE_UNRESTRICTED_EXTENSION_NAME,
 #if defined(LVK_WITH_TRACY)
       VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME,
@@ -4495,6 +6757,60 @@ lvk::Result lvk::VulkanContext::initContext(const HWDeviceDesc& desc
 #endif
   };
 
+  hasMemoryBudget_ = hasExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, allPhysicalDeviceExtensions);
+
+  {
+    VkPhysicalDeviceMemoryProperties memProps = {};
+    vkGetPhysicalDeviceMemoryProperties(vkPhysicalDevice_, &memProps);
+    for (uint32_t i = 0; i != memProps.memoryTypeCount; i++) {
+      if (memProps.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+        hasLazilyAllocatedMemory_ = true;
+      }
+    }
+  }
+
+  if (hasMemoryBudget_) {
+    deviceExtensionNames.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+  }
+
+  VkPhysicalDeviceMultiDrawFeaturesEXT multiDrawFeatures = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT};
+
+  if (hasExtension(VK_EXT_MULTI_DRAW_EXTENSION_NAME, allPhysicalDeviceExtensions)) {
+    VkPhysicalDeviceFeatures2 features = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &multiDrawFeatures};
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    VkPhysicalDeviceMultiDrawPropertiesEXT multiDrawProps = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_PROPERTIES_EXT};
+    VkPhysicalDeviceProperties2 props = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &multiDrawProps};
+    vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &props);
+    hasMultiDraw_ = multiDrawFeatures.multiDraw == VK_TRUE && multiDrawProps.maxMultiDrawCount > 0;
+    maxMultiDrawCount_ = multiDrawProps.maxMultiDrawCount;
+  }
+
+  if (hasMultiDraw_) {
+    deviceExtensionNames.push_back(VK_EXT_MULTI_DRAW_EXTENSION_NAME);
+  }
+
+  VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR};
+  VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+      .pNext = &presentIdFeatures,
+  };
+
+  if (!isHeadless_) {
+    deviceExtensionNames.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+  }
+
+  if (!isHeadless_ && hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME, allPhysicalDeviceExtensions) &&
+      hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME, allPhysicalDeviceExtensions)) {
+    VkPhysicalDeviceFeatures2 features = {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &presentWaitFeatures};
+    vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &features);
+    hasPresentWait_ = presentIdFeatures.presentId == VK_TRUE && presentWaitFeatures.presentWait == VK_TRUE;
+  }
+
+  if (hasPresentWait_) {
+    deviceExtensionNames.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    deviceExtensionNames.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+  }
+
   VkPhysicalDeviceFeatures deviceFeatures10 = {
 #if !defined(__APPLE__)
     .geometryShader = VK_TRUE,
@@ -4570,13 +6886,36 @@ lvk::Result lvk::VulkanContext::initContext(const HWDeviceDesc& desc
   const void* createInfoNext = &deviceFeatures13;
 #endif
 
+  if (hasMultiDraw_) {
+    multiDrawFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT,
+        .pNext = const_cast<void*>(createInfoNext),
+        .multiDraw = VK_TRUE,
+    };
+    createInfoNext = &multiDrawFeatures;
+  }
+
+  if (hasPresentWait_) {
+    presentIdFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+        .pNext = const_cast<void*>(createInfoNext),
+        .presentId = VK_TRUE,
+    };
+    presentWaitFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+        .pNext = &presentIdFeatures,
+        .presentWait = VK_TRUE,
+    };
+    createInfoNext = &presentWaitFeatures;
+  }
+
   const VkDeviceCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
       .pNext = createInfoNext,
       .queueCreateInfoCount = numQueues,
       .pQueueCreateInfos = ciQueue,
-      .enabledExtensionCount = (uint32_t)LVK_ARRAY_NUM_ELEMENTS(deviceExtensionNames),
-      .ppEnabledExtensionNames = deviceExtensionNames,
+      .enabledExtensionCount = (uint32_t)deviceExtensionNames.size(),
+      .ppEnabledExtensionNames = deviceExtensionNames.data(),
       .pEnabledFeatures = &deviceFeatures10,
   };
 
@@ -4812,12 +7151,16 @@ lvk::Result lvk::VulkanContext::initContext(const HWDeviceDesc& desc
   }
 
   if (LVK_VULKAN_USE_VMA) {
-    pimpl_->vma_ = lvk::createVmaAllocator(vkPhysicalDevice_, vkDevice_, vkInstance_, apiVersion);
+    pimpl_->vma_ = lvk::createVmaAllocator(vkPhysicalDevice_, vkDevice_, vkInstance_, apiVersion, hasMemoryBudget_);
     LVK_ASSERT(pimpl_->vma_ != VK_NULL_HANDLE);
   }
 
   stagingDevice_ = std::make_unique<lvk::VulkanStagingDevice>(*this);
 
+  if (config_.transientBufferSize) {
+    transientAllocator_ = std::make_unique<lvk::VulkanTransientAllocator>(*this, config_.transientBufferSize);
+  }
+
   // default texture
   {
     const uint32_t pixel = 0xFF000000;
@@ -4911,10 +7254,10 @@ lvk::Result lvk::VulkanContext::growDescriptorPool(uint32_t maxTextures, uint32_
   }
 
   if (vkDSL_ != VK_NULL_HANDLE) {
-    deferredTask(std::packaged_task<void()>([device = vkDevice_, dsl = vkDSL_]() { vkDestroyDescriptorSetLayout(device, dsl, nullptr); }));
+    retire(RetiredObjectType_DescriptorSetLayout, (uint64_t)vkDSL_);
   }
   if (vkDPool_ != VK_NULL_HANDLE) {
-    deferredTask(std::packaged_task<void()>([device = vkDevice_, dp = vkDPool_]() { vkDestroyDescriptorPool(device, dp, nullptr); }));
+    retire(RetiredObjectType_DescriptorPool, (uint64_t)vkDPool_);
   }
 
   // create default descriptor set layout which is going to be shared by graphics pipelines
@@ -4979,6 +7322,8 @@ lvk::BufferHandle lvk::VulkanContext::createBuffer(VkDeviceSize bufferSize,
                                                    const char* debugName) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
 
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   LVK_ASSERT(bufferSize > 0);
 
 #define ENSURE_BUFFER_SIZE(flag, maxSize)                                                             \
@@ -5002,6 +7347,12 @@ lvk::BufferHandle lvk::VulkanContext::createBuffer(VkDeviceSize bufferSize,
       .vkMemFlags_ = memFlags,
   };
 
+  VulkanBufferMetadata metadata;
+
+  if (debugName) {
+    snprintf(metadata.debugName_, sizeof(metadata.debugName_), "%s", debugName);
+  }
+
   const VkBufferCreateInfo ci = {
       .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
       .pNext = nullptr,
@@ -5041,11 +7392,11 @@ lvk::BufferHandle lvk::VulkanContext::createBuffer(VkDeviceSize bufferSize,
 
     vmaAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
 
-    vmaCreateBuffer((VmaAllocator)getVmaAllocator(), &ci, &vmaAllocInfo, &buf.vkBuffer_, &buf.vmaAllocation_, nullptr);
+    vmaCreateBuffer((VmaAllocator)getVmaAllocator(), &ci, &vmaAllocInfo, &buf.vkBuffer_, &metadata.vmaAllocation_, nullptr);
 
     // handle memory-mapped buffers
     if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-      vmaMapMemory((VmaAllocator)getVmaAllocator(), buf.vmaAllocation_, &buf.mappedPtr_);
+      vmaMapMemory((VmaAllocator)getVmaAllocator(), metadata.vmaAllocation_, &buf.mappedPtr_);
     }
   } else {
     // create buffer
@@ -5059,13 +7410,13 @@ lvk::BufferHandle lvk::VulkanContext::createBuffer(VkDeviceSize bufferSize,
         buf.isCoherentMemory_ = true;
       }
 
-      VK_ASSERT(lvk::allocateMemory(vkPhysicalDevice_, vkDevice_, &requirements, memFlags, &buf.vkMemory_));
-      VK_ASSERT(vkBindBufferMemory(vkDevice_, buf.vkBuffer_, buf.vkMemory_, 0));
+      VK_ASSERT(lvk::allocateMemory(vkPhysicalDevice_, vkDevice_, &requirements, memFlags, &metadata.vkMemory_));
+      VK_ASSERT(vkBindBufferMemory(vkDevice_, buf.vkBuffer_, metadata.vkMemory_, 0));
     }
 
     // handle memory-mapped buffers
     if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-      VK_ASSERT(vkMapMemory(vkDevice_, buf.vkMemory_, 0, buf.bufferSize_, 0, &buf.mappedPtr_));
+      VK_ASSERT(vkMapMemory(vkDevice_, metadata.vkMemory_, 0, buf.bufferSize_, 0, &buf.mappedPtr_));
     }
   }
 
@@ -5084,7 +7435,144 @@ lvk::BufferHandle lvk::VulkanContext::createBuffer(VkDeviceSize bufferSize,
     LVK_ASSERT(buf.vkDeviceAddress_);
   }
 
-  return buffersPool_.create(std::move(buf));
+  BufferHandle handle = buffersPool_.create(std::move(buf), std::move(metadata));
+  buffersPool_.get(handle)->metadata_ = buffersPool_.getCold(handle);
+
+  return handle;
+}
+
+lvk::BufferHandle lvk::VulkanContext::createSuballocatedBuffer(VkDeviceSize bufferSize,
+                                                               VkBufferUsageFlags usageFlags,
+                                                               VkMemoryPropertyFlags memFlags,
+                                                               lvk::Result* outResult,
+                                                               const char* debugName) {
+  LVK_PROFILER_FUNCTION();
+
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
+  LVK_ASSERT(bufferSize > 0);
+  LVK_ASSERT(bufferSize <= kMaxSuballocationSize);
+
+  const VkPhysicalDeviceLimits& limits = getVkPhysicalDeviceProperties().limits;
+
+  // every sub-allocation has to be usable as a uniform/storage buffer range and as a flushable host-visible range
+  const VkDeviceSize alignment = std::max({VkDeviceSize(16),
+                                           limits.minUniformBufferOffsetAlignment,
+                                           limits.minStorageBufferOffsetAlignment,
+                                           limits.nonCoherentAtomSize});
+
+  const VmaVirtualAllocationCreateInfo allocCreateInfo = {
+      .size = bufferSize,
+      .alignment = alignment,
+  };
+
+  BufferSuballocationBlock* block = nullptr;
+  VmaVirtualAllocation allocation = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+
+  for (BufferSuballocationBlock& b : pimpl_->suballocationBlocks_) {
+    if (b.usageFlags_ == usageFlags && b.memFlags_ == memFlags &&
+        vmaVirtualAllocate(b.vmaVirtualBlock_, &allocCreateInfo, &allocation, &offset) == VK_SUCCESS) {
+      block = &b;
+      break;
+    }
+  }
+
+  if (!block) {
+    // uniform buffers cannot be bound beyond maxUniformBufferRange
+    const VkDeviceSize blockSize = (usageFlags & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+                                       ? std::min(kSuballocationBlockSize, VkDeviceSize(limits.maxUniformBufferRange))
+                                       : kSuballocationBlockSize;
+
+    if (!LVK_VERIFY(bufferSize <= blockSize)) {
+      Result::setResult(outResult, Result(Result::Code::ArgumentOutOfRange, "Buffer size exceeds the sub-allocation block size"));
+      return {};
+    }
+
+    char blockName[256] = {0};
+    snprintf(blockName, sizeof(blockName) - 1, "Buffer: sub-allocation block %u", (uint32_t)pimpl_->suballocationBlocks_.size());
+
+    Result result;
+    BufferHandle blockBuffer = createBuffer(blockSize, usageFlags, memFlags, &result, blockName);
+
+    if (!result.isOk()) {
+      Result::setResult(outResult, result);
+      return {};
+    }
+
+    const VmaVirtualBlockCreateInfo blockCreateInfo = {
+        .size = blockSize,
+    };
+
+    VmaVirtualBlock vmaBlock = VK_NULL_HANDLE;
+
+    if (!LVK_VERIFY(vmaCreateVirtualBlock(&blockCreateInfo, &vmaBlock) == VK_SUCCESS)) {
+      destroy(blockBuffer);
+      Result::setResult(outResult, Result(Result::Code::RuntimeError, "Cannot create a sub-allocation block"));
+      return {};
+    }
+
+    block = &pimpl_->suballocationBlocks_.emplace_back(BufferSuballocationBlock{
+        .buffer_ = blockBuffer,
+        .usageFlags_ = usageFlags,
+        .memFlags_ = memFlags,
+        .vmaVirtualBlock_ = vmaBlock,
+    });
+
+    VK_ASSERT(vmaVirtualAllocate(block->vmaVirtualBlock_, &allocCreateInfo, &allocation, &offset));
+  }
+
+  const lvk::VulkanBuffer* parent = buffersPool_.get(block->buffer_);
+  const lvk::VulkanBufferMetadata* parentMetadata = buffersPool_.getCold(block->buffer_);
+
+  LVK_ASSERT(parent);
+
+  // share the backing VkBuffer and its memory; everything that addresses the buffer goes through `bufferOffset_`
+  VulkanBuffer buf = {
+      .vkBuffer_ = parent->vkBuffer_,
+      .vkDeviceAddress_ = parent->vkDeviceAddress_ ? parent->vkDeviceAddress_ + offset : 0,
+      .bufferSize_ = bufferSize,
+      .bufferOffset_ = offset,
+      .vkUsageFlags_ = usageFlags,
+      .vkMemFlags_ = memFlags,
+      .mappedPtr_ = parent->mappedPtr_ ? static_cast<uint8_t*>(parent->mappedPtr_) + offset : nullptr,
+      .isCoherentMemory_ = parent->isCoherentMemory_,
+      .isSuballocated_ = true,
+  };
+
+  VulkanBufferMetadata metadata = {
+      .vkMemory_ = parentMetadata->vkMemory_,
+      .vmaAllocation_ = parentMetadata->vmaAllocation_,
+      .vmaVirtualBlock_ = block->vmaVirtualBlock_,
+      .vmaVirtualAllocation_ = allocation,
+  };
+
+  if (debugName) {
+    snprintf(metadata.debugName_, sizeof(metadata.debugName_), "%s", debugName);
+  }
+
+  Result::setResult(outResult, Result());
+
+  BufferHandle handle = buffersPool_.create(std::move(buf), std::move(metadata));
+  buffersPool_.get(handle)->metadata_ = buffersPool_.getCold(handle);
+
+  return handle;
+}
+
+void lvk::VulkanContext::destroySuballocationBlocks() {
+  // pending deferred tasks may still release sub-allocations
+  waitDeferredTasks();
+
+  for (BufferSuballocationBlock& b : pimpl_->suballocationBlocks_) {
+    if (!vmaIsVirtualBlockEmpty(b.vmaVirtualBlock_)) {
+      LLOGW("Leaked sub-allocated buffers in a block of %u bytes\n", (uint32_t)buffersPool_.get(b.buffer_)->bufferSize_);
+      vmaClearVirtualBlock(b.vmaVirtualBlock_);
+    }
+    vmaDestroyVirtualBlock(b.vmaVirtualBlock_);
+    destroy(b.buffer_);
+  }
+
+  pimpl_->suballocationBlocks_.clear();
 }
 
 void lvk::VulkanContext::bindDefaultDescriptorSets(VkCommandBuffer cmdBuf, VkPipelineBindPoint bindPoint, VkPipelineLayout layout) const {
@@ -5099,6 +7587,8 @@ void lvk::VulkanContext::checkAndUpdateDescriptorSets() {
     return;
   }
 
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   // newly created resources can be used immediately - make sure they are put into descriptor sets
   LVK_PROFILER_FUNCTION();
 
@@ -5111,10 +7601,10 @@ void lvk::VulkanContext::checkAndUpdateDescriptorSets() {
   uint32_t newMaxTextures = currentMaxTextures_;
   uint32_t newMaxSamplers = currentMaxSamplers_;
 
-  while (texturesPool_.objects_.size() > newMaxTextures) {
+  while (texturesPool_.numSlots() > newMaxTextures) {
     newMaxTextures *= 2;
   }
-  while (samplersPool_.objects_.size() > newMaxSamplers) {
+  while (samplersPool_.numSlots() > newMaxSamplers) {
     newMaxSamplers *= 2;
   }
   if (newMaxTextures != currentMaxTextures_ || newMaxSamplers != currentMaxSamplers_) {
@@ -5129,11 +7619,11 @@ void lvk::VulkanContext::checkAndUpdateDescriptorSets() {
   infoStorageImages.reserve(texturesPool_.numObjects());
 
   // use the dummy texture to avoid sparse array
-  VkImageView dummyImageView = texturesPool_.objects_[0].obj_.imageView_;
+  VkImageView dummyImageView = texturesPool_.objectAt(0).imageView_;
 
-  for (const auto& obj : texturesPool_.objects_) {
-    const VulkanImage& img = obj.obj_;
-    const VkImageView view = obj.obj_.imageView_;
+  for (uint32_t i = 0; i != texturesPool_.numSlots(); i++) {
+    const VulkanImage& img = texturesPool_.objectAt(i);
+    const VkImageView view = img.imageView_;
     // multisampled images cannot be directly accessed from shaders
     const bool isTextureAvailable = (img.vkSamples_ & VK_SAMPLE_COUNT_1_BIT) == VK_SAMPLE_COUNT_1_BIT;
     const bool isSampledImage = isTextureAvailable && img.isSampledImage();
@@ -5145,10 +7635,11 @@ void lvk::VulkanContext::checkAndUpdateDescriptorSets() {
 
   // 2. Samplers
   std::vector<VkDescriptorImageInfo> infoSamplers;
-  infoSamplers.reserve(samplersPool_.objects_.size());
+  infoSamplers.reserve(samplersPool_.numSlots());
 
-  for (const auto& sampler : samplersPool_.objects_) {
-    infoSamplers.push_back({sampler.obj_ ? sampler.obj_ : samplersPool_.objects_[0].obj_, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED});
+  for (uint32_t i = 0; i != samplersPool_.numSlots(); i++) {
+    const VkSampler sampler = samplersPool_.objectAt(i);
+    infoSamplers.push_back({sampler ? sampler : samplersPool_.objectAt(0), VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED});
   }
 
   VkWriteDescriptorSet write[kBinding_NumBindings] = {};
@@ -5205,6 +7696,8 @@ void lvk::VulkanContext::checkAndUpdateDescriptorSets() {
 lvk::SamplerHandle lvk::VulkanContext::createSampler(const VkSamplerCreateInfo& ci, lvk::Result* outResult, const char* debugName) {
   LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_CREATE);
 
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   VkSampler sampler = VK_NULL_HANDLE;
 
   VK_ASSERT(vkCreateSampler(vkDevice_, &ci, nullptr, &sampler));
@@ -5289,29 +7782,255 @@ std::vector<uint8_t> lvk::VulkanContext::getPipelineCacheData() const {
 }
 
 void lvk::VulkanContext::deferredTask(std::packaged_task<void()>&& task, SubmitHandle handle) const {
+  if (!isRenderThread()) {
+    // the render thread owns the submit handles; empty handles are assigned in the next processDeferredTasks()
+    std::lock_guard lock(pimpl_->pendingMutex_);
+    pimpl_->pendingDeferredTasks_.emplace_back(std::move(task), handle);
+    return;
+  }
   if (handle.empty()) {
     handle = immediate_->getLastSubmitHandle();
   }
   pimpl_->deferredTasks_.emplace_back(std::move(task), handle);
 }
 
+void lvk::VulkanContext::retire(RetiredObjectType type, uint64_t handle, uint64_t extra) const {
+  if (!handle) {
+    return;
+  }
+  if (!isRenderThread()) {
+    // stamped with a submit handle in the next processDeferredTasks()
+    std::lock_guard lock(pimpl_->pendingMutex_);
+    pimpl_->pendingRetired_.push_back({type, handle, extra, SubmitHandle()});
+    return;
+  }
+  pimpl_->retired_.push_back({type, handle, extra, immediate_->getLastSubmitHandle()});
+}
+
 void* lvk::VulkanContext::getVmaAllocator() const {
   return pimpl_->vma_;
 }
 
+void lvk::VulkanContext::flushPendingUploads() {
+  std::vector<DeferredUpload> uploads;
+
+  {
+    std::lock_guard lock(pimpl_->pendingMutex_);
+    if (pimpl_->pendingUploads_.empty()) {
+      return;
+    }
+    uploads.swap(pimpl_->pendingUploads_);
+  }
+
+  LVK_PROFILER_FUNCTION();
+
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
+  for (const DeferredUpload& u : uploads) {
+    // the resource could have been destroyed before its upload got a chance to run
+    if (u.buffer ? !buffersPool_.isAlive(u.buffer) : !texturesPool_.isAlive(u.texture)) {
+      continue;
+    }
+    if (u.buffer) {
+      upload(u.buffer, u.getData(), u.getSize(), u.offset);
+    } else if (u.generateMipmap) {
+      generateMipmap(u.texture);
+    } else {
+      upload(u.texture, u.range, u.getData());
+    }
+  }
+}
+
+bool lvk::VulkanContext::isRenderThread() const {
+  return std::this_thread::get_id() == pimpl_->renderThreadId_;
+}
+
+void lvk::VulkanContext::takePendingDeferredTasks() const {
+  std::lock_guard lock(pimpl_->pendingMutex_);
+  for (DeferredTask& task : pimpl_->pendingDeferredTasks_) {
+    const SubmitHandle handle = task.handle_.empty() ? immediate_->getLastSubmitHandle() : task.handle_;
+    pimpl_->deferredTasks_.emplace_back(std::move(task.task_), handle);
+  }
+  pimpl_->pendingDeferredTasks_.clear();
+  for (RetiredObject& obj : pimpl_->pendingRetired_) {
+    obj.submitHandle = immediate_->getLastSubmitHandle();
+    pimpl_->retired_.push_back(obj);
+  }
+  pimpl_->pendingRetired_.clear();
+}
+
 void lvk::VulkanContext::processDeferredTasks() const {
+  takePendingDeferredTasks();
+
+  // tasks can release sub-allocations which are also touched by resource creation on other threads
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   while (!pimpl_->deferredTasks_.empty() && immediate_->isReady(pimpl_->deferredTasks_.front().handle_, true)) {
     pimpl_->deferredTasks_.front().task_();
     pimpl_->deferredTasks_.pop_front();
   }
+
+  processRetiredObjects(config_.maxRetiredObjectsPerFrame);
+}
+
+void lvk::VulkanContext::processRetiredObjects(uint32_t maxObjects) const {
+  std::vector<RetiredObject>& retired = pimpl_->retired_;
+  size_t& head = pimpl_->retiredHead_;
+
+  const size_t end = maxObjects ? std::min(retired.size(), head + maxObjects) : retired.size();
+
+  size_t last = head;
+
+  while (last != end && immediate_->isReady(retired[last].submitHandle, true)) {
+    last++;
+  }
+
+  if (last == head) {
+    return;
+  }
+
+  LVK_PROFILER_FUNCTION_COLOR(LVK_PROFILER_COLOR_DESTROY);
+
+  const bool useThread = config_.retireOnBackgroundThread;
+
+  if (useThread && !pimpl_->retireThread_.joinable()) {
+    pimpl_->retireThread_ = std::thread([this]() { retireThreadFunc(); });
+  }
+
+  {
+    std::unique_lock lock(pimpl_->retireMutex_, std::defer_lock);
+    if (useThread) {
+      lock.lock();
+    }
+    for (size_t i = head; i != last; i++) {
+      // sub-allocation blocks and command pools are not thread-safe, so ranges and command buffers always go back to them on this thread
+      const bool isRenderThreadOnly =
+          retired[i].type == RetiredObjectType_VirtualAllocation || retired[i].type == RetiredObjectType_CommandBuffer;
+      if (useThread && !isRenderThreadOnly) {
+        pimpl_->retireThreadQueue_.push_back(retired[i]);
+      } else {
+        destroyRetiredObject(retired[i]);
+      }
+    }
+  }
+  if (useThread) {
+    pimpl_->retireThreadCondition_.notify_one();
+  }
+
+  head = last;
+
+  if (head == retired.size()) {
+    retired.clear();
+    head = 0;
+  } else if (head > 1024 && head * 2 > retired.size()) {
+    // compact without giving the memory back
+    retired.erase(retired.begin(), retired.begin() + head);
+    head = 0;
+  }
+}
+
+void lvk::VulkanContext::destroyRetiredObject(const RetiredObject& obj) const {
+  const VkDevice device = vkDevice_;
+
+  switch (obj.type) {
+  case RetiredObjectType_ImageView:
+    vkDestroyImageView(device, (VkImageView)obj.handle, nullptr);
+    break;
+  case RetiredObjectType_Image:
+    vkDestroyImage(device, (VkImage)obj.handle, nullptr);
+    if (obj.extra) {
+      vkFreeMemory(device, (VkDeviceMemory)obj.extra, nullptr);
+    }
+    break;
+  case RetiredObjectType_ImageVma:
+    vmaDestroyImage(pimpl_->vma_, (VkImage)obj.handle, (VmaAllocation)obj.extra);
+    break;
+  case RetiredObjectType_Buffer:
+    vkDestroyBuffer(device, (VkBuffer)obj.handle, nullptr);
+    if (obj.extra) {
+      vkFreeMemory(device, (VkDeviceMemory)obj.extra, nullptr);
+    }
+    break;
+  case RetiredObjectType_BufferVma:
+    vmaDestroyBuffer(pimpl_->vma_, (VkBuffer)obj.handle, (VmaAllocation)obj.extra);
+    break;
+  case RetiredObjectType_VirtualAllocation:
+    vmaVirtualFree((VmaVirtualBlock)obj.handle, (VmaVirtualAllocation)obj.extra);
+    break;
+  case RetiredObjectType_Sampler:
+    vkDestroySampler(device, (VkSampler)obj.handle, nullptr);
+    break;
+  case RetiredObjectType_Pipeline:
+    vkDestroyPipeline(device, (VkPipeline)obj.handle, nullptr);
+    break;
+  case RetiredObjectType_PipelineLayout:
+    vkDestroyPipelineLayout(device, (VkPipelineLayout)obj.handle, nullptr);
+    break;
+  case RetiredObjectType_QueryPool:
+    vkDestroyQueryPool(device, (VkQueryPool)obj.handle, nullptr);
+    break;
+  case RetiredObjectType_DescriptorSetLayout:
+    vkDestroyDescriptorSetLayout(device, (VkDescriptorSetLayout)obj.handle, nullptr);
+    break;
+  case RetiredObjectType_DescriptorPool:
+    vkDestroyDescriptorPool(device, (VkDescriptorPool)obj.handle, nullptr);
+    break;
+  case RetiredObjectType_CommandBuffer: {
+    const VkCommandBuffer cmdBuf = (VkCommandBuffer)obj.handle;
+    vkFreeCommandBuffers(device, (VkCommandPool)obj.extra, 1, &cmdBuf);
+    break;
+  }
+  }
+}
+
+void lvk::VulkanContext::retireThreadFunc() const {
+  std::vector<RetiredObject> batch;
+
+  std::unique_lock lock(pimpl_->retireMutex_);
+
+  for (;;) {
+    pimpl_->retireThreadCondition_.wait(lock, [this]() { return pimpl_->retireThreadExit_ || !pimpl_->retireThreadQueue_.empty(); });
+    if (pimpl_->retireThreadQueue_.empty()) {
+      // exit only when everything has been destroyed
+      return;
+    }
+    batch.swap(pimpl_->retireThreadQueue_);
+    pimpl_->retireThreadBusy_ = true;
+    lock.unlock();
+    for (const RetiredObject& obj : batch) {
+      destroyRetiredObject(obj);
+    }
+    batch.clear();
+    lock.lock();
+    pimpl_->retireThreadBusy_ = false;
+    pimpl_->retireThreadCondition_.notify_all();
+  }
 }
 
 void lvk::VulkanContext::waitDeferredTasks() {
+  // objects destroyed on other threads since the last submit() would be leaked otherwise, e.g. when the context is destroyed
+  takePendingDeferredTasks();
+
+  // let the background thread finish its work first; it never takes `resourcesMutex_`
+  if (pimpl_->retireThread_.joinable()) {
+    std::unique_lock lock(pimpl_->retireMutex_);
+    pimpl_->retireThreadCondition_.wait(lock, [this]() { return pimpl_->retireThreadQueue_.empty() && !pimpl_->retireThreadBusy_; });
+  }
+
+  std::lock_guard lock(pimpl_->resourcesMutex_);
+
   for (auto& task : pimpl_->deferredTasks_) {
     immediate_->wait(task.handle_);
     task.task_();
   }
   pimpl_->deferredTasks_.clear();
+
+  for (size_t i = pimpl_->retiredHead_; i != pimpl_->retired_.size(); i++) {
+    immediate_->wait(pimpl_->retired_[i].submitHandle);
+    destroyRetiredObject(pimpl_->retired_[i]);
+  }
+  pimpl_->retired_.clear();
+  pimpl_->retiredHead_ = 0;
 }
 
 void lvk::VulkanContext::invokeShaderModuleErrorCallback(int line, int col, const char* debugName, VkShaderModule sm) {
@@ -5320,11 +8039,9 @@ void lvk::VulkanContext::invokeShaderModuleErrorCallback(int line, int col, cons
   }
 
   lvk::ShaderModuleHandle handle;
-
-  for (uint32_t i = 0; i != shaderModulesPool_.objects_.size(); i++) {
-    if (shaderModulesPool_.objects_[i].obj_.sm == sm) {
-      handle = shaderModulesPool_.getHandle(i);
-    }
+  {
+    std::lock_guard lock(pimpl_->resourcesMutex_);
+    handle = shaderModulesPool_.findObjectByKey((uint64_t)sm);
   }
 
   if (!handle.empty()) {
@@ -15,6 +15,7 @@
 #include <openxr/openxr_platform.h>
 #endif
 
+#include <atomic>
 #include <deque>
 #include <future>
 #include <memory>
@@ -23,6 +24,24 @@
 namespace lvk {
 
 class VulkanContext;
+struct RetiredObject;
+
+// Vulkan objects which are destroyed through the retirement queue once the GPU is done with them
+enum RetiredObjectType : uint8_t {
+  RetiredObjectType_ImageView,
+  RetiredObjectType_Image, // optional VkDeviceMemory
+  RetiredObjectType_ImageVma, // VmaAllocation
+  RetiredObjectType_Buffer, // VkDeviceMemory
+  RetiredObjectType_BufferVma, // VmaAllocation
+  RetiredObjectType_VirtualAllocation, // VmaVirtualBlock + VmaVirtualAllocation
+  RetiredObjectType_Sampler,
+  RetiredObjectType_Pipeline,
+  RetiredObjectType_PipelineLayout,
+  RetiredObjectType_QueryPool,
+  RetiredObjectType_DescriptorSetLayout,
+  RetiredObjectType_DescriptorPool,
+  RetiredObjectType_CommandBuffer, // VkCommandPool
+};
 
 #ifdef LVK_WITH_OPENXR
 struct XRParams {
@@ -40,10 +59,14 @@ struct DeviceQueues final {
   VkQueue computeQueue = VK_NULL_HANDLE;
 };
 
+struct VulkanBufferMetadata;
+
+// data touched by binding and updating a buffer; everything needed only to create or destroy it lives in VulkanBufferMetadata
 struct VulkanBuffer final {
   // clang-format off
   [[nodiscard]] inline uint8_t* getMappedPtr() const { return static_cast<uint8_t*>(mappedPtr_); }
   [[nodiscard]] inline bool isMapped() const { return mappedPtr_ != nullptr;  }
+  [[nodiscard]] inline bool isSuballocated() const { return isSuballocated_; }
   // clang-format on
 
   void bufferSubData(const VulkanContext& ctx, size_t offset, size_t size, const void* data);
@@ -53,17 +76,85 @@ struct VulkanBuffer final {
 
  public:
   VkBuffer vkBuffer_ = VK_NULL_HANDLE;
-  VkDeviceMemory vkMemory_ = VK_NULL_HANDLE;
-  VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
   VkDeviceAddress vkDeviceAddress_ = 0;
   VkDeviceSize bufferSize_ = 0;
+  // sub-allocated buffers share `vkBuffer_` with a backing buffer; `vkDeviceAddress_` and `mappedPtr_` already include this offset
+  VkDeviceSize bufferOffset_ = 0;
   VkBufferUsageFlags vkUsageFlags_ = 0;
   VkMemoryPropertyFlags vkMemFlags_ = 0;
   void* mappedPtr_ = nullptr;
   bool isCoherentMemory_ = false;
+  bool isSuballocated_ = false;
+  // the cold data of this buffer in buffersPool_, set once the buffer is in the pool; chunk addresses are stable
+  VulkanBufferMetadata* metadata_ = nullptr;
+};
+
+// rarely accessed buffer data, stored apart from VulkanBuffer in buffersPool_
+struct VulkanBufferMetadata final {
+  char debugName_[MemoryAllocationStats::LVK_MAX_DEBUG_NAME_SIZE] = {0};
+  VkDeviceMemory vkMemory_ = VK_NULL_HANDLE;
+  VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
+  // a range of a backing buffer, see VulkanBuffer::bufferOffset_
+  VmaVirtualBlock vmaVirtualBlock_ = VK_NULL_HANDLE;
+  VmaVirtualAllocation vmaVirtualAllocation_ = VK_NULL_HANDLE;
 };
 
+// device memory shared by textures created with createAliasedTextures(); freed when the last of them is destroyed
+struct VulkanAliasedMemory final {
+  ~VulkanAliasedMemory();
+
+  VkDevice device_ = VK_NULL_HANDLE;
+  VmaAllocator vma_ = VK_NULL_HANDLE;
+  VkDeviceMemory vkMemory_ = VK_NULL_HANDLE;
+  VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
+  VkDeviceSize size_ = 0;
+  char debugName_[MemoryAllocationStats::LVK_MAX_DEBUG_NAME_SIZE] = {0};
+};
+
+// placement of an aliased texture inside VulkanAliasedMemory
+struct TextureAliasing {
+  VkMemoryRequirements requirements = {};
+  std::shared_ptr<VulkanAliasedMemory> memory;
+  VkDeviceSize offset = 0;
+};
+
+// collects image and buffer barriers and records them with as few vkCmdPipelineBarrier2() calls as possible
+class VulkanBarrierBatch final {
+ public:
+  VulkanBarrierBatch() = default;
+  explicit VulkanBarrierBatch(VkCommandBuffer cmdBuf) : cmdBuf_(cmdBuf) {}
+
+  void add(const VkImageMemoryBarrier2& barrier);
+  void add(const VkBufferMemoryBarrier2& barrier);
+  // records everything collected so far; a full batch is flushed by add()
+  void flush();
+  [[nodiscard]] bool empty() const {
+    return !numImageBarriers_ && !numBufferBarriers_;
+  }
+
+ private:
+  enum { kMaxBarriers = 32 };
+  VkCommandBuffer cmdBuf_ = VK_NULL_HANDLE;
+  VkImageMemoryBarrier2 imageBarriers_[kMaxBarriers];
+  VkBufferMemoryBarrier2 bufferBarriers_[kMaxBarriers];
+  uint32_t numImageBarriers_ = 0;
+  uint32_t numBufferBarriers_ = 0;
+};
+
+struct VulkanImageMetadata;
+
+// data touched by binding textures, barriers and render passes; everything else lives in VulkanImageMetadata
 struct VulkanImage final {
+  // layout and last access of one (level, layer) pair
+  struct SubresourceState {
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE; // none means unknown, barriers use the caller's stages then
+    VkAccessFlags2 writes = VK_ACCESS_2_NONE; // writes which still have to be made available
+    bool operator==(const SubresourceState& other) const {
+      return layout == other.layout && stages == other.stages && writes == other.writes;
+    }
+  };
+
   // clang-format off
   [[nodiscard]] inline bool isSampledImage() const { return (vkUsageFlags_ & VK_IMAGE_USAGE_SAMPLED_BIT) > 0; }
   [[nodiscard]] inline bool isStorageImage() const { return (vkUsageFlags_ & VK_IMAGE_USAGE_STORAGE_BIT) > 0; }
@@ -93,6 +184,25 @@ struct VulkanImage final {
                         VkPipelineStageFlags srcStageMask,
                         VkPipelineStageFlags dstStageMask,
                         const VkImageSubresourceRange& subresourceRange) const;
+  // access masks are deduced from the stages
+  void transitionLayout(VulkanBarrierBatch& batch,
+                        VkImageLayout newImageLayout,
+                        VkPipelineStageFlags srcStageMask,
+                        VkPipelineStageFlags dstStageMask,
+                        const VkImageSubresourceRange& subresourceRange) const;
+  // Every (level, layer) in `range` waits for its own tracked last access; `srcStages`/`srcAccess` are used when it is unknown or when
+  // discarding. Subresources with identical states share one barrier. `discard` drops the previous contents but keeps the dependency.
+  void transitionLayout(VulkanBarrierBatch& batch,
+                        VkImageLayout newImageLayout,
+                        VkPipelineStageFlags2 srcStages,
+                        VkAccessFlags2 srcAccess,
+                        VkPipelineStageFlags2 dstStages,
+                        VkAccessFlags2 dstAccess,
+                        const VkImageSubresourceRange& range,
+                        bool discard = false) const;
+  // records a layout change which happened without transitionLayout(), e.g. at the end of a render pass
+  void setSubresourceState(const VkImageSubresourceRange& range, const SubresourceState& state) const;
+  [[nodiscard]] VkImageLayout getSubresourceLayout(uint32_t level, uint32_t layer) const;
 
   [[nodiscard]] VkImageAspectFlags getImageAspectFlags() const;
 
@@ -105,24 +215,40 @@ struct VulkanImage final {
  public:
   VkImage vkImage_ = VK_NULL_HANDLE;
   VkImageUsageFlags vkUsageFlags_ = 0;
-  VkDeviceMemory vkMemory_ = VK_NULL_HANDLE;
-  VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
-  VkFormatProperties vkFormatProperties_ = {};
   VkExtent3D vkExtent_ = {0, 0, 0};
   VkImageType vkType_ = VK_IMAGE_TYPE_MAX_ENUM;
   VkFormat vkImageFormat_ = VK_FORMAT_UNDEFINED;
   VkSampleCountFlagBits vkSamples_ = VK_SAMPLE_COUNT_1_BIT;
-  void* mappedPtr_ = nullptr;
   bool isSwapchainImage_ = false;
   uint32_t numLevels_ = 1u;
   uint32_t numLayers_ = 1u;
   bool isDepthFormat_ = false;
   bool isStencilFormat_ = false;
-  // current image layout
+  // layout of the whole image; once subresources diverge, the most recently set layout (see VulkanImageMetadata::subresourceStates_)
   mutable VkImageLayout vkImageLayout_ = VK_IMAGE_LAYOUT_UNDEFINED;
   // precached image views - owned by this VulkanImage
   VkImageView imageView_ = VK_NULL_HANDLE; // default view with all mip-levels
-  VkImageView imageViewForFramebuffer_[LVK_MAX_MIP_LEVELS][16] = {}; // max 6 faces for cubemap rendering
+  // the cold data of this image in texturesPool_, set once the image is in the pool; chunk addresses are stable
+  VulkanImageMetadata* metadata_ = nullptr;
+};
+
+// rarely accessed image data, stored apart from VulkanImage in texturesPool_
+struct VulkanImageMetadata final {
+  char debugName_[MemoryAllocationStats::LVK_MAX_DEBUG_NAME_SIZE] = {0};
+  VkDeviceMemory vkMemory_ = VK_NULL_HANDLE;
+  VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
+  void* mappedPtr_ = nullptr;
+  VkFormatProperties vkFormatProperties_ = {};
+  // per (level, layer) states indexed by `layer * numLevels_ + level`, allocated on the first transition
+  std::vector<VulkanImage::SubresourceState> subresourceStates_;
+  // sparse cache of single level/layer views for framebuffers, created on demand - most textures never need any
+  struct FramebufferView {
+    uint8_t level = 0;
+    uint16_t layer = 0;
+    VkImageView view = VK_NULL_HANDLE;
+  };
+  std::vector<FramebufferView> framebufferViews_;
+  // set when the image does not own its memory
 };
 
 class VulkanSwapchain final {
@@ -138,6 +264,20 @@ class VulkanSwapchain final {
   TextureHandle getCurrentTexture();
   const VkSurfaceFormatKHR& getSurfaceFormat() const;
   uint32_t getNumSwapchainImages() const;
+  uint64_t getLastPresentId() const {
+    return lastPresentId_;
+  }
+  bool waitForPresent(uint64_t presentId, uint64_t timeoutNanoseconds) const;
+  // headless contexts have no surface: the images are regular textures which are cycled by present() and never shown
+  bool isVirtual() const {
+    return isVirtual_;
+  }
+  // virtual swapchain only: records a copy of the image being presented into its slot of the readback ring
+  void recordReadback(VkCommandBuffer cmdBuf, VulkanBarrierBatch& barriers, const VulkanImage& image);
+  uint64_t readbackPresentedImage(void* outData, size_t sizeInBytes);
+
+ private:
+  void createVirtualImages();
 
  private:
   VulkanContext& ctx_;
@@ -151,8 +291,17 @@ class VulkanSwapchain final {
   VkSwapchainKHR swapchain_ = VK_NULL_HANDLE;
   VkSurfaceFormatKHR surfaceFormat_ = {.format = VK_FORMAT_UNDEFINED};
   TextureHandle swapchainTextures_[LVK_MAX_SWAPCHAIN_IMAGES] = {};
-  VkSemaphore acquireSemaphore_ = VK_NULL_HANDLE;
-  VkFence acquireFence_ = VK_NULL_HANDLE;
+  // one acquire semaphore per swapchain image, used round-robin; each one can be reused once the submit which waited on it has finished
+  VkSemaphore acquireSemaphores_[LVK_MAX_SWAPCHAIN_IMAGES] = {};
+  SubmitHandle acquireSubmitHandles_[LVK_MAX_SWAPCHAIN_IMAGES] = {};
+  uint32_t acquireSemaphoreIndex_ = 0;
+  uint64_t lastPresentId_ = 0;
+  // virtual swapchain: the submit which presented each image and the pipelined readback ring (one buffer per image)
+  bool isVirtual_ = false;
+  SubmitHandle presentSubmitHandles_[LVK_MAX_SWAPCHAIN_IMAGES] = {};
+  BufferHandle readbackBuffers_[LVK_MAX_SWAPCHAIN_IMAGES] = {};
+  uint64_t readbackPresentIds_[LVK_MAX_SWAPCHAIN_IMAGES] = {}; // 0 means the slot is empty
+  uint64_t lastReadbackPresentId_ = 0;
 };
 
 class VulkanImmediateCommands final {
@@ -296,10 +445,21 @@ struct ShaderModuleState final {
   uint32_t pushConstantsSize = 0;
 };
 
+struct CommandBundleState final {
+  CommandBundleDesc desc_;
+  // only `cmdBuf_` is used, it is a secondary command buffer allocated from VulkanContext::bundlesCommandPool_
+  VulkanImmediateCommands::CommandBufferWrapper wrapper_;
+  // non-owning, the descriptor set and render pipelines which were current when the bundle was recorded
+  VkDescriptorSet lastVkDescriptorSet_ = VK_NULL_HANDLE;
+  std::vector<std::pair<RenderPipelineHandle, VkPipeline>> pipelines_;
+};
+
 class CommandBuffer final : public ICommandBuffer {
  public:
   CommandBuffer() = default;
   explicit CommandBuffer(VulkanContext* ctx);
+  // records `bundle` into its secondary command buffer, which has to be in the recording state
+  CommandBuffer(VulkanContext* ctx, CommandBundleState* bundle);
   ~CommandBuffer() override;
 
   CommandBuffer& operator=(CommandBuffer&& other) = default;
@@ -312,6 +472,14 @@ class CommandBuffer final : public ICommandBuffer {
 
   void cmdBindComputePipeline(lvk::ComputePipelineHandle handle) override;
   void cmdDispatchThreadGroups(const Dimensions& threadgroupCount, const Dependencies& deps) override;
+  void cmdDispatchThreadGroupsIndirect(BufferHandle indirectBuffer, size_t indirectBufferOffset, const Dependencies& deps) override;
+  void cmdPipelineBarrier(const BufferBarrier* bufferBarriers,
+                          uint32_t numBufferBarriers,
+                          const TextureBarrier* textureBarriers,
+                          uint32_t numTextureBarriers) override;
+  void cmdAliasTexture(TextureHandle from, TextureHandle to) override;
+  void setAutomaticBarriers(bool enabled) override;
+  void cmdFillBuffer(BufferHandle buffer, size_t bufferOffset, size_t size, uint32_t data) override;
 
   void cmdPushDebugGroupLabel(const char* label, uint32_t colorRGBA) const override;
   void cmdInsertDebugEventLabel(const char* label, uint32_t colorRGBA) const override;
@@ -336,6 +504,8 @@ class CommandBuffer final : public ICommandBuffer {
                       uint32_t firstIndex,
                       int32_t vertexOffset,
                       uint32_t baseInstance) override;
+  void cmdDrawMulti(const DrawInfo* draws, uint32_t numDraws, uint32_t instanceCount, uint32_t baseInstance) override;
+  void cmdDrawIndexedMulti(const DrawIndexedInfo* draws, uint32_t numDraws, uint32_t instanceCount, uint32_t baseInstance) override;
   void cmdDrawIndirect(BufferHandle indirectBuffer, size_t indirectBufferOffset, uint32_t drawCount, uint32_t stride = 0) override;
   void cmdDrawIndexedIndirect(BufferHandle indirectBuffer, size_t indirectBufferOffset, uint32_t drawCount, uint32_t stride = 0) override;
   void cmdDrawIndexedIndirectCount(BufferHandle indirectBuffer,
@@ -351,26 +521,105 @@ class CommandBuffer final : public ICommandBuffer {
   void cmdResetQueryPool(QueryPoolHandle pool, uint32_t firstQuery, uint32_t queryCount) override;
   void cmdWriteTimestamp(QueryPoolHandle pool, uint32_t query) override;
 
+  void cmdExecuteBundle(CommandBundleHandle bundle) override;
+
+  CommandBufferStats getStats() const override {
+    return stats_;
+  }
+
+  // pending barriers are recorded first, so native commands see the same ordering as LVK commands
   VkCommandBuffer getVkCommandBuffer() const {
+    barriers_.flush();
     return wrapper_ ? wrapper_->cmdBuf_ : VK_NULL_HANDLE;
   }
 
  private:
   void useComputeTexture(TextureHandle texture);
-  void bufferBarrier(BufferHandle handle, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage);
+  void useComputeDependencies(const Dependencies& deps);
+  void useRenderingDependencies(const lvk::RenderPass& renderPass, const lvk::Framebuffer& fb, const Dependencies& deps);
+  // `unknownStages`/`unknownWrites` stand for accesses before this command buffer, they are used for ranges which were not accessed yet
+  void useBufferRange(BufferHandle handle,
+                      size_t offset,
+                      size_t size,
+                      VkPipelineStageFlags2 stages,
+                      VkAccessFlags2 access,
+                      bool isWrite,
+                      VkPipelineStageFlags2 unknownStages,
+                      VkAccessFlags2 unknownWrites);
+  void forgetBufferRange(BufferHandle handle);
+  // called after every dispatch and render pass: the next access waits for the last tracked writer and for the `unknownStages` fallback
+  void invalidateBufferVisibility();
+  void flushBarriers();
+  void onPipelineLayoutBound(VkPipelineLayout layout);
+  void resetRenderingState();
+
+ private:
+  // shadow copy of the state recorded into the command buffer; zeroes and `false` mean "unknown"
+  struct ShadowState {
+    enum { kMaxPushConstantsSize = 128 }; // guaranteed by the Vulkan spec
+    VkViewport viewport = {};
+    VkRect2D scissor = {};
+    VkBuffer vertexBuffers[VertexInput::LVK_VERTEX_BUFFER_MAX] = {};
+    VkDeviceSize vertexBufferOffsets[VertexInput::LVK_VERTEX_BUFFER_MAX] = {};
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+    VkDeviceSize indexBufferOffset = 0;
+    VkIndexType indexType = VK_INDEX_TYPE_MAX_ENUM;
+    VkCompareOp depthCompareOp = VK_COMPARE_OP_MAX_ENUM;
+    VkBool32 depthWriteEnable = VK_FALSE;
+    VkBool32 depthTestEnable = VK_FALSE;
+    VkBool32 depthBiasEnable = VK_FALSE;
+    float depthBias[3] = {}; // constant, clamp, slope
+    float blendColor[4] = {};
+    bool hasViewport = false;
+    bool hasScissor = false;
+    bool hasDepthWriteEnable = false;
+    bool hasDepthTestEnable = false;
+    bool hasDepthBiasEnable = false;
+    bool hasDepthBias = false;
+    bool hasBlendColor = false;
+    // only the last vkCmdPushConstants() call is remembered
+    VkPipelineLayout pushConstantsLayout = VK_NULL_HANDLE;
+    uint32_t pushConstantsOffset = 0;
+    uint32_t pushConstantsSize = 0;
+    uint8_t pushConstants[kMaxPushConstantsSize];
+  };
+  // accesses to a range of a VkBuffer recorded in this command buffer
+  struct BufferRangeState {
+    uint64_t buffer = 0; // VkBuffer, suballocated buffers share it
+    VkDeviceSize begin = 0;
+    VkDeviceSize end = 0;
+    VkPipelineStageFlags2 writeStages = VK_PIPELINE_STAGE_2_NONE; // the last writer
+    VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+    VkPipelineStageFlags2 visibleStages = VK_PIPELINE_STAGE_2_NONE; // stages which already see the last write
+    VkPipelineStageFlags2 readStages = VK_PIPELINE_STAGE_2_NONE; // readers since the last write
+    bool hasUntrackedWrites = false; // a dispatch or render pass since the last write may have written it via a device address
+  };
 
  private:
   friend class VulkanContext;
 
   VulkanContext* ctx_ = nullptr;
   const VulkanImmediateCommands::CommandBufferWrapper* wrapper_ = nullptr;
+  // not null when recording a command bundle
+  CommandBundleState* bundle_ = nullptr;
+  // barriers are merged and recorded right before the next command which needs them
+  mutable VulkanBarrierBatch barriers_;
+  // sorted by (buffer, begin), ranges never overlap
+  std::vector<BufferRangeState> bufferStates_;
+  std::vector<BufferRangeState> bufferStatesScratch_;
 
   lvk::Framebuffer framebuffer_ = {};
+  lvk::RenderPass renderPass_ = {};
   lvk::SubmitHandle lastSubmitHandle_ = {};
 
   VkPipeline lastPipelineBound_ = VK_NULL_HANDLE;
+  VkPipelineLayout lastPipelineLayoutBound_ = VK_NULL_HANDLE;
+
+  ShadowState state_ = {};
+  CommandBufferStats stats_ = {};
 
   bool isRendering_ = false;
+  bool automaticBarriers_ = true;
 
   lvk::RenderPipelineHandle currentPipelineGraphics_ = {};
   lvk::ComputePipelineHandle currentPipelineCompute_ = {};
@@ -400,6 +649,8 @@ class VulkanStagingDevice final {
                     VkImageSubresourceRange range,
                     VkFormat format,
                     void* outData);
+  // total size of the staging buffer and how many bytes of it are still used by the GPU
+  void getMemoryUsage(uint64_t& outSize, uint64_t& outInUse) const;
 
  private:
   struct MemoryRegionDesc {
@@ -427,6 +678,46 @@ class VulkanStagingDevice final {
   std::deque<MemoryRegionDesc> regions_;
 };
 
+// linear allocator over a persistently mapped ring buffer; memory is recycled in whole frames tracked by submit handles
+class VulkanTransientAllocator final {
+ public:
+  explicit VulkanTransientAllocator(VulkanContext& ctx, size_t size);
+  ~VulkanTransientAllocator() = default;
+
+  VulkanTransientAllocator(const VulkanTransientAllocator&) = delete;
+  VulkanTransientAllocator& operator=(const VulkanTransientAllocator&) = delete;
+
+  TransientAllocation allocate(size_t size, size_t alignment);
+  // make host writes visible to the device before a submit
+  void flush();
+  // everything allocated since the previous call can be reused once `handle` is complete
+  void endFrame(SubmitHandle handle);
+
+ private:
+  struct FrameDesc {
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    SubmitHandle handle_ = {};
+  };
+
+  bool tryAllocate(size_t size, size_t alignment, size_t& outOffset);
+  void retireCompletedFrames();
+  size_t getTail() const {
+    return frames_.empty() ? frameBegin_ : frames_.front().begin_;
+  }
+
+ private:
+  VulkanContext& ctx_;
+  lvk::Holder<BufferHandle> buffer_;
+  uint8_t* mappedPtr_ = nullptr;
+  uint64_t gpuAddress_ = 0;
+  size_t size_ = 0;
+  size_t head_ = 0;
+  size_t frameBegin_ = 0;
+  bool isFrameEmpty_ = true;
+  std::deque<FrameDesc> frames_;
+};
+
 class VulkanContext final : public IContext {
  public:
   VulkanContext(const lvk::ContextConfig& config, void* window, void* display = nullptr, VkSurfaceKHR surface = VK_NULL_HANDLE);
@@ -442,15 +733,29 @@ class VulkanContext final : public IContext {
   SubmitHandle submit(lvk::ICommandBuffer& commandBuffer, TextureHandle present) override;
   void wait(SubmitHandle handle) override;
 
+  uint32_t beginFrame() override;
+  void endFrame(SubmitHandle handle) override;
+  uint32_t getFrameIndex() const override {
+    return frameIndex_;
+  }
+  uint32_t getNumFramesInFlight() const override {
+    return numFramesInFlight_;
+  }
+
   Holder<BufferHandle> createBuffer(const BufferDesc& desc, Result* outResult) override;
   Holder<SamplerHandle> createSampler(const SamplerStateDesc& desc, Result* outResult) override;
   Holder<TextureHandle> createTexture(const TextureDesc& desc, const char* debugName, Result* outResult) override;
+  Result createAliasedTextures(const AliasedTextureDesc* descs,
+                               uint32_t numTextures,
+                               Holder<TextureHandle>* outTextures,
+                               const char* debugName) override;
 
   Holder<ComputePipelineHandle> createComputePipeline(const ComputePipelineDesc& desc, Result* outResult) override;
   Holder<RenderPipelineHandle> createRenderPipeline(const RenderPipelineDesc& desc, Result* outResult) override;
   Holder<ShaderModuleHandle> createShaderModule(const ShaderModuleDesc& desc, Result* outResult) override;
 
   Holder<QueryPoolHandle> createQueryPool(uint32_t numQueries, const char* debugName, Result* outResult) override;
+  Holder<CommandBundleHandle> createCommandBundle(const CommandBundleDesc& desc, Result* outResult) override;
 
   void destroy(ComputePipelineHandle handle) override;
   void destroy(RenderPipelineHandle handle) override;
@@ -459,35 +764,46 @@ class VulkanContext final : public IContext {
   void destroy(BufferHandle handle) override;
   void destroy(TextureHandle handle) override;
   void destroy(QueryPoolHandle handle) override;
+  void destroy(CommandBundleHandle handle) override;
   void destroy(Framebuffer& fb) override;
 
   Result upload(BufferHandle handle, const void* data, size_t size, size_t offset) override;
   uint8_t* getMappedPtr(BufferHandle handle) const override;
   uint64_t gpuAddress(BufferHandle handle, size_t offset) const override;
   void flushMappedMemory(BufferHandle handle, size_t offset, size_t size) const override;
+  TransientAllocation allocateTransient(size_t size, size_t alignment) override;
+  Result uploadFromFile(BufferHandle handle, const char* fileName, size_t fileOffset, size_t size, size_t bufferOffset) override;
 
   Result upload(TextureHandle handle, const TextureRangeDesc& range, const void* data) override;
   Result download(TextureHandle handle, const TextureRangeDesc& range, void* outData) override;
+  Result uploadFromFile(TextureHandle handle, const TextureRangeDesc& range, const char* fileName, size_t fileOffset) override;
   Dimensions getDimensions(TextureHandle handle) const override;
   void generateMipmap(TextureHandle handle) const override;
   Format getFormat(TextureHandle handle) const override;
+  uint8_t getTextureUsage(TextureHandle handle) const override;
 
   TextureHandle getCurrentSwapchainTexture() override;
   Format getSwapchainFormat() const override;
   ColorSpace getSwapChainColorSpace() const override;
   uint32_t getNumSwapchainImages() const override;
   void recreateSwapchain(int newWidth, int newHeight) override;
+  uint64_t getLastPresentId() const override;
+  bool waitForPresent(uint64_t presentId, uint64_t timeoutNanoseconds) override;
+  uint64_t readbackPresentedImage(void* outData, size_t sizeInBytes) override;
 
   uint32_t getFramebufferMSAABitMask() const override;
 
   double getTimestampPeriodToMs() const override;
   bool getQueryPoolResults(QueryPoolHandle pool, uint32_t firstQuery, uint32_t queryCount, size_t dataSize, void* outData, size_t stride)
       const override;
+  MemoryStats getMemoryStats() const override;
 
   ///////////////
 
   VkPipeline getVkPipeline(ComputePipelineHandle handle);
   VkPipeline getVkPipeline(RenderPipelineHandle handle);
+  // re-records the bundle if anything it references was rebuilt since it was recorded
+  lvk::Result updateCommandBundle(CommandBundleState& bundle, bool force = false);
 
   uint32_t queryDevices(HWDeviceType deviceType, HWDeviceDesc* outDevices, uint32_t maxOutDevices = 1);
   lvk::Result initContext(const HWDeviceDesc& desc
@@ -503,6 +819,11 @@ class VulkanContext final : public IContext {
                             VkMemoryPropertyFlags memFlags,
                             lvk::Result* outResult,
                             const char* debugName = nullptr);
+  BufferHandle createSuballocatedBuffer(VkDeviceSize bufferSize,
+                                        VkBufferUsageFlags usageFlags,
+                                        VkMemoryPropertyFlags memFlags,
+                                        lvk::Result* outResult,
+                                        const char* debugName = nullptr);
   SamplerHandle createSampler(const VkSamplerCreateInfo& ci, lvk::Result* outResult, const char* debugName = nullptr);
 
   bool hasSwapchain() const noexcept {
@@ -513,6 +834,10 @@ class VulkanContext final : public IContext {
     return vkPhysicalDeviceProperties2_.properties;
   }
 
+  const VkPhysicalDeviceVulkan12Properties& getVkPhysicalDeviceVulkan12Properties() const {
+    return vkPhysicalDeviceVulkan12Properties_;
+  }
+
   VkFormat getClosestDepthStencilFormat(lvk::Format desiredFormat) const;
 
   // OpenXR needs Vulkan instance to find physical device
@@ -530,6 +855,8 @@ class VulkanContext final : public IContext {
 
   // execute a task some time in the future after the submit handle finished processing
   void deferredTask(std::packaged_task<void()>&& task, SubmitHandle handle = SubmitHandle()) const;
+  // destroy a Vulkan object after all work submitted so far finished processing; does not allocate in the steady state
+  void retire(RetiredObjectType type, uint64_t handle, uint64_t extra = 0) const;
 
   void* getVmaAllocator() const;
 
@@ -545,8 +872,20 @@ class VulkanContext final : public IContext {
 #endif
   void createSurface(void* window, void* display);
   void querySurfaceCapabilities();
+  // moves tasks and objects handed over from other threads into the render thread's queues
+  void takePendingDeferredTasks() const;
   void processDeferredTasks() const;
+  void processRetiredObjects(uint32_t maxObjects) const;
+  void destroyRetiredObject(const RetiredObject& obj) const;
+  void retireThreadFunc() const;
   void waitDeferredTasks();
+  bool isRenderThread() const;
+  // records uploads and mip-map generation requested from other threads
+  void flushPendingUploads();
+  void destroySuballocationBlocks();
+  void checkMemoryBudget();
+  // when `aliasing` is not null, the image is bound to `aliasing->memory` or, if there is no memory yet, only its requirements are queried
+  Holder<TextureHandle> createTextureImpl(const TextureDesc& desc, const char* debugName, Result* outResult, TextureAliasing* aliasing);
   lvk::Result growDescriptorPool(uint32_t maxTextures, uint32_t maxSamplers);
   ShaderModuleState createShaderModuleFromSPIRV(const void* spirv, size_t numBytes, const char* debugName, Result* outResult) const;
   ShaderModuleState createShaderModuleFromGLSL(ShaderStage stage, const char* source, const char* debugName, Result* outResult) const;
@@ -558,6 +897,8 @@ class VulkanContext final : public IContext {
   VkInstance vkInstance_ = VK_NULL_HANDLE;
   VkDebugUtilsMessengerEXT vkDebugUtilsMessenger_ = VK_NULL_HANDLE;
   VkSurfaceKHR vkSurface_ = VK_NULL_HANDLE;
+  // no window and no surface: WSI extensions are not used and the swapchain is virtual
+  bool isHeadless_ = false;
   VkPhysicalDevice vkPhysicalDevice_ = VK_NULL_HANDLE;
   VkDevice vkDevice_ = VK_NULL_HANDLE;
 
@@ -589,20 +930,38 @@ class VulkanContext final : public IContext {
   std::unique_ptr<lvk::VulkanSwapchain> swapchain_;
   std::unique_ptr<lvk::VulkanImmediateCommands> immediate_;
   std::unique_ptr<lvk::VulkanStagingDevice> stagingDevice_;
+  std::unique_ptr<lvk::VulkanTransientAllocator> transientAllocator_;
   uint32_t currentMaxTextures_ = 16;
   uint32_t currentMaxSamplers_ = 16;
   VkDescriptorSetLayout vkDSL_ = VK_NULL_HANDLE;
   VkDescriptorPool vkDPool_ = VK_NULL_HANDLE;
   VkDescriptorSet vkDSet_ = VK_NULL_HANDLE;
+  // secondary command buffers of command bundles, render thread only
+  VkCommandPool bundlesCommandPool_ = VK_NULL_HANDLE;
   // don't use staging on devices with shared host-visible memory
   bool useStaging_ = true;
+  // VK_EXT_memory_budget is optional
+  bool hasMemoryBudget_ = false;
+  // tile-based GPUs can back transient attachments with lazily allocated memory
+  bool hasLazilyAllocatedMemory_ = false;
+  // VK_EXT_multi_draw is optional
+  bool hasMultiDraw_ = false;
+  uint32_t maxMultiDrawCount_ = 0;
+  // VK_KHR_present_id and VK_KHR_present_wait are optional and enabled together
+  bool hasPresentWait_ = false;
+
+  // frame pacing: the last submit of every frame in flight
+  SubmitHandle frameSubmitHandles_[LVK_MAX_FRAMES_IN_FLIGHT] = {};
+  uint32_t numFramesInFlight_ = 1;
+  uint32_t frameIndex_ = 0;
+  bool isInsideFrame_ = false;
 
   std::unique_ptr<struct VulkanContextImpl> pimpl_;
 
   VkPipelineCache pipelineCache_ = VK_NULL_HANDLE;
 
   // a texture/sampler was created since the last descriptor set update
-  mutable bool awaitingCreation_ = false;
+  mutable std::atomic<bool> awaitingCreation_ = false;
 
   lvk::ContextConfig config_;
 
@@ -612,9 +971,10 @@ class VulkanContext final : public IContext {
   lvk::Pool<lvk::RenderPipeline, lvk::RenderPipelineState> renderPipelinesPool_;
   lvk::Pool<lvk::ComputePipeline, lvk::ComputePipelineState> computePipelinesPool_;
   lvk::Pool<lvk::Sampler, VkSampler> samplersPool_;
-  lvk::Pool<lvk::Buffer, lvk::VulkanBuffer> buffersPool_;
-  lvk::Pool<lvk::Texture, lvk::VulkanImage> texturesPool_;
+  lvk::Pool<lvk::Buffer, lvk::VulkanBuffer, lvk::VulkanBufferMetadata> buffersPool_;
+  lvk::Pool<lvk::Texture, lvk::VulkanImage, lvk::VulkanImageMetadata> texturesPool_;
   lvk::Pool<lvk::QueryPool, VkQueryPool> queriesPool_;
+  lvk::Pool<lvk::CommandBundle, lvk::CommandBundleState> commandBundlesPool_;
 };
 
 } // namespace lvk
@@ -308,7 +308,8 @@ uint32_t lvk::findQueueFamilyIndex(VkPhysicalDevice physDev, VkQueueFlags flags)
 VmaAllocator lvk::createVmaAllocator(VkPhysicalDevice physDev,
                                      VkDevice device,
                                      VkInstance instance,
-                                     uint32_t apiVersion) {
+                                     uint32_t apiVersion,
+                                     bool enableMemoryBudget) {
   const VmaVulkanFunctions funcs = {
       .vkGetInstanceProcAddr = vkGetInstanceProcAddr,
       .vkGetDeviceProcAddr = vkGetDeviceProcAddr,
@@ -339,7 +340,7 @@ VmaAllocator lvk::createVmaAllocator(VkPhysicalDevice physDev,
   };
 
   const VmaAllocatorCreateInfo ci = {
-      .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+      .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT | (enableMemoryBudget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0u),
       .physicalDevice = physDev,
       .device = device,
       .preferredLargeHeapBlockSize = 0,
@@ -62,7 +62,7 @@ namespace lvk {
 
 VkSemaphore createSemaphore(VkDevice device, const char* debugName);
 VkFence createFence(VkDevice device, const char* debugName);
-VmaAllocator createVmaAllocator(VkPhysicalDevice physDev, VkDevice device, VkInstance instance, uint32_t apiVersion);
+VmaAllocator createVmaAllocator(VkPhysicalDevice physDev, VkDevice device, VkInstance instance, uint32_t apiVersion, bool enableMemoryBudget);
 uint32_t findQueueFamilyIndex(VkPhysicalDevice physDev, VkQueueFlags flags);
 VkResult setDebugObjectName(VkDevice device, VkObjectType type, uint64_t handle, const char* name);
 VkResult allocateMemory(VkPhysicalDevice physDev,
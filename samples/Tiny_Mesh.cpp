@@ -120,15 +120,12 @@ int width_ = 1280;
 int height_ = 1024;
 FramesPerSecondCounter fps_;
 
-constexpr uint32_t kNumBufferedFrames = 3;
-
 std::unique_ptr<lvk::IContext> ctx_;
 lvk::Framebuffer framebuffer_;
 lvk::Holder<lvk::ShaderModuleHandle> vert_;
 lvk::Holder<lvk::ShaderModuleHandle> frag_;
 lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_Mesh_;
 lvk::Holder<lvk::BufferHandle> vb0_, ib0_; // buffers for vertices and indices
-std::vector<lvk::Holder<lvk::BufferHandle>> ubPerFrame_, ubPerObject_;
 lvk::Holder<lvk::TextureHandle> texture0_, texture1_;
 lvk::Holder<lvk::SamplerHandle> sampler_;
 lvk::RenderPass renderPass_;
@@ -210,19 +207,7 @@ void init() {
                                 .data = indexData,
                                 .debugName = "Buffer: index"},
                                nullptr);
-  // create an Uniform buffers to store uniforms for 2 objects
-  for (uint32_t i = 0; i != kNumBufferedFrames; i++) {
-    ubPerFrame_.push_back(ctx_->createBuffer({.usage = lvk::BufferUsageBits_Uniform,
-                                                 .storage = lvk::StorageType_HostVisible,
-                                                 .size = sizeof(UniformsPerFrame),
-                                                 .debugName = "Buffer: uniforms (per frame)"},
-                                                nullptr));
-    ubPerObject_.push_back(ctx_->createBuffer({.usage = lvk::BufferUsageBits_Uniform,
-                                                  .storage = lvk::StorageType_HostVisible,
-                                                  .size = kNumCubes * sizeof(UniformsPerObject),
-                                                  .debugName = "Buffer: uniforms (per object)"},
-                                                 nullptr));
-  }
+  // uniforms are allocated every frame using IContext::allocateTransient()
 
   depthState_ = {.compareOp = lvk::CompareOp_Less, .isDepthWriteEnabled = true};
 
@@ -304,8 +289,6 @@ void destroy() {
 
   vb0_ = nullptr;
   ib0_ = nullptr;
-  ubPerFrame_.clear();
-  ubPerObject_.clear();
   vert_ = nullptr;
   frag_ = nullptr;
   renderPipelineState_Mesh_ = nullptr;
@@ -347,7 +330,7 @@ void resize() {
   ctx_->recreateSwapchain(width_, height_);
 }
 
-void render(uint32_t frameIndex, float time) {
+void render(float time) {
   LVK_PROFILER_FUNCTION();
 
   if (!width_ || !height_) {
@@ -376,7 +359,7 @@ void render(uint32_t frameIndex, float time) {
       .texture1 = texture1_.index(),
       .sampler = sampler_.index(),
   };
-  ctx_->upload(ubPerFrame_[frameIndex], &perFrame, sizeof(perFrame));
+  const lvk::TransientAllocation ubPerFrame = ctx_->allocateTransient(perFrame);
 
   // rotate cubes around random axes
   for (uint32_t i = 0; i != kNumCubes; i++) {
@@ -388,7 +371,7 @@ void render(uint32_t frameIndex, float time) {
     perObject[i].model = glm::rotate(glm::translate(mat4(1.0f), offset), direction * time, axis_[i]);
   }
 
-  ctx_->upload(ubPerObject_[frameIndex], &perObject, sizeof(perObject));
+  const lvk::TransientAllocation ubPerObject = ctx_->allocateTransient(perObject);
 
   // Command buffers (1-N per thread): create, submit and forget
   lvk::ICommandBuffer& buffer = ctx_->acquireCommandBuffer();
@@ -412,8 +395,8 @@ void render(uint32_t frameIndex, float time) {
         uint64_t perObject;
         uint64_t vb;
       } bindings = {
-          .perFrame = ctx_->gpuAddress(ubPerFrame_[frameIndex]),
-          .perObject = ctx_->gpuAddress(ubPerObject_[frameIndex], i * sizeof(UniformsPerObject)),
+          .perFrame = ubPerFrame.gpuAddress,
+          .perObject = ubPerObject.gpuAddress + i * sizeof(UniformsPerObject),
           .vb = ctx_->gpuAddress(vb0_),
       };
       buffer.cmdPushConstants(bindings);
@@ -479,16 +462,13 @@ int main(int argc, char* argv[]) {
 
   double prevTime = glfwGetTime();
 
-  uint32_t frameIndex = 0;
-
   // Main loop
   while (!glfwWindowShouldClose(window)) {
     const double newTime = glfwGetTime();
     fps_.tick(newTime - prevTime);
     prevTime = newTime;
-    render(frameIndex, (float)newTime);
+    render((float)newTime);
     glfwPollEvents();
-    frameIndex = (frameIndex + 1) % kNumBufferedFrames;
   }
 
   // destroy all the Vulkan stuff before closing the window
@@ -546,8 +526,6 @@ void android_main(android_app* app) {
   timespec prevTime = {0, 0};
   clock_gettime(CLOCK_MONOTONIC, &prevTime);
 
-  uint32_t frameIndex = 0;
-
   int events = 0;
   android_poll_source* source = nullptr;
   do {
@@ -558,14 +536,13 @@ void android_main(android_app* app) {
     LLOGL("FPS: %.1f\n", fps_.getFPS());
     prevTime = newTime;
     if (ctx_) {
-      render(frameIndex, (float)newTimeSec);
+      render((float)newTimeSec);
     }
     if (ALooper_pollOnce(0, nullptr, &events, (void**)&source) >= 0) {
       if (source) {
         source->process(app, source);
       }
     }
-    frameIndex = (frameIndex + 1) % kNumBufferedFrames;
   } while (!app->destroyRequested);
 }
 } // extern "C"
@@ -48,6 +48,7 @@
 #include <tiny_obj_loader.h>
 
 #include <lvk/LVK.h>
+#include <lvk/HelpersCulling.h>
 #include <lvk/HelpersImGui.h>
 #include <implot/implot.h>
 
@@ -59,7 +60,7 @@
 #include <GLFW/glfw3.h>
 #endif
 
-constexpr uint32_t kMeshCacheVersion = 0xC0DE0009;
+constexpr uint32_t kMeshCacheVersion = 0xC0DE000A;
 #if !defined(__APPLE__)
 constexpr int kNumSamplesMSAA = 8;
 #else
@@ -83,9 +84,21 @@ std::string folderContentRoot;
 std::unique_ptr<lvk::ImGuiRenderer> imgui_;
 
 enum GPUTimestamp {
-  GPUTimestamp_BeginSceneRendering = 0,
+  GPUTimestamp_BeginCullingEarly = 0,
+  GPUTimestamp_EndCullingEarly,
+
+  GPUTimestamp_BeginSceneRendering,
   GPUTimestamp_EndSceneRendering,
 
+  GPUTimestamp_BeginDepthPyramid,
+  GPUTimestamp_EndDepthPyramid,
+
+  GPUTimestamp_BeginCullingLate,
+  GPUTimestamp_EndCullingLate,
+
+  GPUTimestamp_BeginSceneRenderingLate,
+  GPUTimestamp_EndSceneRenderingLate,
+
   GPUTimestamp_BeginComputePass,
   GPUTimestamp_EndComputePass,
 
@@ -473,14 +486,14 @@ int width_ = 0;
 int height_ = 0;
 FramesPerSecondCounter fps_;
 
-constexpr uint32_t kNumBufferedFrames = 3;
-
 std::unique_ptr<lvk::IContext> ctx_;
 lvk::Framebuffer fbMain_; // swapchain
 lvk::Framebuffer fbOffscreen_;
 lvk::Holder<lvk::TextureHandle> fbOffscreenColor_;
 lvk::Holder<lvk::TextureHandle> fbOffscreenDepth_;
 lvk::Holder<lvk::TextureHandle> fbOffscreenResolve_;
+lvk::Holder<lvk::TextureHandle> fbOffscreenDepthResolve_; // MSAA only: the depth pyramid needs a single-sampled depth
+lvk::Framebuffer fbOffscreenEarly_; // fbOffscreen_ plus the depth resolve target
 lvk::Framebuffer fbShadowMap_;
 lvk::Holder<lvk::ShaderModuleHandle> smMeshVert_;
 lvk::Holder<lvk::ShaderModuleHandle> smMeshFrag_;
@@ -501,13 +514,15 @@ lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_Skybox_;
 lvk::Holder<lvk::RenderPipelineHandle> renderPipelineState_Fullscreen_;
 lvk::Holder<lvk::BufferHandle> vb0_, ib0_; // buffers for vertices and indices
 lvk::Holder<lvk::BufferHandle> sbMaterials_; // storage buffer for materials
-std::vector<lvk::Holder<lvk::BufferHandle>> ubPerFrame_, ubPerFrameShadow_, ubPerObject_;
+lvk::FrameRing<lvk::Holder<lvk::BufferHandle>> ubPerFrame_, ubPerFrameShadow_, ubPerObject_;
 lvk::Holder<lvk::SamplerHandle> sampler_;
 lvk::Holder<lvk::SamplerHandle> samplerShadow_;
 lvk::Holder<lvk::TextureHandle> textureDummyWhite_;
 lvk::Holder<lvk::TextureHandle> skyboxTextureReference_;
 lvk::Holder<lvk::TextureHandle> skyboxTextureIrradiance_;
 lvk::RenderPass renderPassOffscreen_;
+lvk::RenderPass renderPassOffscreenEarly_;
+lvk::RenderPass renderPassOffscreenLate_;
 lvk::RenderPass renderPassMain_;
 lvk::RenderPass renderPassShadow_;
 lvk::DepthState depthState_;
@@ -533,7 +548,23 @@ struct VertexData {
 
 std::vector<VertexData> vertexData_;
 std::vector<uint32_t> indexData_;
-std::vector<uint32_t> shapeVertexCnt_;
+// vertex and index data is streamed into GPU buffers directly from the memory-mapped cache file
+uint32_t numVertices_ = 0;
+uint32_t numIndices_ = 0;
+size_t cacheOffsetVertices_ = 0;
+size_t cacheOffsetIndices_ = 0;
+// per-shape index ranges and bounding spheres for GPU culling
+std::vector<lvk::CullingShape> shapes_;
+std::unique_ptr<lvk::GPUCuller> culler_;
+std::unique_ptr<lvk::DepthPyramid> depthPyramid_;
+bool enableCulling_ = true;
+bool enableOcclusionCulling_ = true;
+
+enum CullingView {
+  CullingView_Main = 0,
+  CullingView_Shadow,
+  CullingView_NUM_VIEWS,
+};
 
 struct UniformsPerFrame {
   mat4 proj;
@@ -597,15 +628,14 @@ struct LoadedImage {
 
 struct LoadedMaterial {
   size_t idx = 0;
-  LoadedImage ambient;
-  LoadedImage diffuse;
-  LoadedImage alpha;
+  MaterialTextures textures; // created on the loader pool
 };
 
 // file name -> LoadedImage
 std::mutex imagesCacheMutex_;
 std::unordered_map<std::string, LoadedImage> imagesCache_; // accessible only from the loader pool (multiple threads)
-std::unordered_map<std::string, lvk::Holder<lvk::TextureHandle>> texturesCache_; // accessible the main thread
+std::mutex texturesCacheMutex_;
+std::unordered_map<std::string, lvk::Holder<lvk::TextureHandle>> texturesCache_; // accessible from the loader pool (multiple threads)
 std::vector<LoadedMaterial> loadedMaterials_;
 std::mutex loadedMaterialsMutex_;
 std::atomic<bool> loaderShouldExit_ = false;
@@ -667,25 +697,28 @@ bool init() {
         nullptr);
   }
 
-  // create an Uniform buffers to store uniforms for 2 objects
-  for (uint32_t i = 0; i != kNumBufferedFrames; i++) {
-    ubPerFrame_.push_back(ctx_->createBuffer({.usage = lvk::BufferUsageBits_Uniform,
-                                                 .storage = lvk::StorageType_HostVisible,
-                                                 .size = sizeof(UniformsPerFrame),
-                                                 .debugName = "Buffer: uniforms (per frame)"},
-                                                nullptr));
-    ubPerFrameShadow_.push_back(
-        ctx_->createBuffer({.usage = lvk::BufferUsageBits_Uniform,
-                               .storage = lvk::StorageType_HostVisible,
-                               .size = sizeof(UniformsPerFrame),
-                               .debugName = "Buffer: uniforms (per frame shadow)"},
-                              nullptr));
-    ubPerObject_.push_back(ctx_->createBuffer({.usage = lvk::BufferUsageBits_Uniform,
-                                                  .storage = lvk::StorageType_HostVisible,
-                                                  .size = sizeof(UniformsPerObject),
-                                                  .debugName = "Buffer: uniforms (per object)"},
-                                                 nullptr));
-  }
+  // create an Uniform buffers to store uniforms for 2 objects, one set per frame in flight
+  ubPerFrame_ = {ctx_.get(), [](uint32_t) {
+                   return ctx_->createBuffer({.usage = lvk::BufferUsageBits_Uniform,
+                                              .storage = lvk::StorageType_HostVisible,
+                                              .size = sizeof(UniformsPerFrame),
+                                              .debugName = "Buffer: uniforms (per frame)"},
+                                             nullptr);
+                 }};
+  ubPerFrameShadow_ = {ctx_.get(), [](uint32_t) {
+                         return ctx_->createBuffer({.usage = lvk::BufferUsageBits_Uniform,
+                                                    .storage = lvk::StorageType_HostVisible,
+                                                    .size = sizeof(UniformsPerFrame),
+                                                    .debugName = "Buffer: uniforms (per frame shadow)"},
+                                                   nullptr);
+                       }};
+  ubPerObject_ = {ctx_.get(), [](uint32_t) {
+                    return ctx_->createBuffer({.usage = lvk::BufferUsageBits_Uniform,
+                                               .storage = lvk::StorageType_HostVisible,
+                                               .size = sizeof(UniformsPerObject),
+                                               .debugName = "Buffer: uniforms (per object)"},
+                                              nullptr);
+                  }};
 
   depthState_ = {.compareOp = lvk::CompareOp_Less, .isDepthWriteEnabled = true};
   depthStateLEqual_ = {.compareOp = lvk::CompareOp_LessEqual, .isDepthWriteEnabled = true};
@@ -715,10 +748,32 @@ bool init() {
           .clearColor = {0.0f, 0.0f, 0.0f, 1.0f},
       }},
       .depth = {
+          .loadOp = lvk::LoadOp_Clear,
+          .storeOp = kNumSamplesMSAA > 1 ? lvk::StoreOp_DontCare : lvk::StoreOp_Store,
+          .clearDepth = 1.0f,
+      }};
+  // two-phase occlusion culling: the early pass keeps (and resolves) its depth for the depth pyramid, the late pass resolves color
+  renderPassOffscreenEarly_ = {
+      .color = {{
           .loadOp = lvk::LoadOp_Clear,
           .storeOp = lvk::StoreOp_Store,
+          .clearColor = {0.0f, 0.0f, 0.0f, 1.0f},
+      }},
+      .depth = {
+          .loadOp = lvk::LoadOp_Clear,
+          .storeOp = lvk::StoreOp_Store,
+          .resolveMode = lvk::ResolveMode_Max, // the farthest sample keeps the occlusion test conservative
           .clearDepth = 1.0f,
       }};
+  renderPassOffscreenLate_ = {
+      .color = {{
+          .loadOp = lvk::LoadOp_Load,
+          .storeOp = kNumSamplesMSAA > 1 ? lvk::StoreOp_MsaaResolve : lvk::StoreOp_Store,
+      }},
+      .depth = {
+          .loadOp = lvk::LoadOp_Load,
+          .storeOp = kNumSamplesMSAA > 1 ? lvk::StoreOp_DontCare : lvk::StoreOp_Store,
+      }};
 
   renderPassMain_ = {
       .color = {{.loadOp = lvk::LoadOp_Clear,
@@ -754,14 +809,22 @@ bool init() {
 }
 
 void destroy() {
+  printf("Waiting for the loader thread to exit...\n");
+
+  // loader threads create textures, so they have to be finished before the context goes away
+  loaderShouldExit_.store(true, std::memory_order_release);
+  loaderPool_ = nullptr;
+
   imgui_ = nullptr;
+  culler_ = nullptr;
+  depthPyramid_ = nullptr;
 
   vb0_ = nullptr;
   ib0_ = nullptr;
   sbMaterials_ = nullptr;
-  ubPerFrame_.clear();
-  ubPerFrameShadow_.clear();
-  ubPerObject_.clear();
+  ubPerFrame_ = {};
+  ubPerFrameShadow_ = {};
+  ubPerObject_ = {};
   smMeshVert_ = nullptr;
   smMeshFrag_ = nullptr;
   smMeshWireframeVert_ = nullptr;
@@ -791,12 +854,9 @@ void destroy() {
   fbOffscreenColor_ = nullptr;
   fbOffscreenDepth_ = nullptr;
   fbOffscreenResolve_ = nullptr;
+  fbOffscreenDepthResolve_ = nullptr;
   queryPoolTimestamps_ = nullptr;
   ctx_ = nullptr;
-
-  printf("Waiting for the loader thread to exit...\n");
-
-  loaderPool_ = nullptr;
 }
 
 void normalizeName(std::string& name) {
@@ -832,11 +892,9 @@ bool loadAndCache(const char* cacheFileName) {
   }
 
   // loop over shapes as described in https://github.com/tinyobjloader/tinyobjloader
-  std::vector<std::vector<VertexData>> resplitShapes;
-  std::vector<VertexData> shapeData;
-  resplitShapes.resize(materials.size());
-  int prevIndex = shapes[0].mesh.material_ids[0];
   for (size_t s = 0; s < shapes.size(); s++) {
+    // every shape is repacked on its own so that it occupies a contiguous range of the index buffer
+    std::vector<VertexData> shapeData;
     size_t index_offset = 0;
     for (size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); f++) {
       LVK_ASSERT(shapes[s].mesh.num_face_vertices[f] == 3);
@@ -865,43 +923,57 @@ bool loadAndCache(const char* cacheFileName) {
 
         LVK_ASSERT(mtlIndex >= 0 && mtlIndex < materials.size());
 
-        if (prevIndex != mtlIndex) {
-          resplitShapes[prevIndex].insert(resplitShapes[prevIndex].end(), shapeData.begin(), shapeData.end());
-          shapeData.clear();
-          prevIndex = mtlIndex;
-        }
-        vertexData_.push_back({pos, glm::packSnorm3x10_1x2(vec4(normal, 0)), glm::packHalf2x16(uv), (uint32_t)mtlIndex});
         shapeData.push_back({pos, glm::packSnorm3x10_1x2(vec4(normal, 0)), glm::packHalf2x16(uv), (uint32_t)mtlIndex});
       }
       index_offset += 3;
     }
-  }
-  resplitShapes[prevIndex].insert(resplitShapes[prevIndex].end(), shapeData.begin(), shapeData.end());
-  shapeData.clear();
-  for (auto shape : resplitShapes) {
-    shapeData.insert(shapeData.end(), shape.begin(), shape.end());
-    shapeVertexCnt_.emplace_back((uint32_t)shape.size());
-  }
 
-  // repack the mesh as described in https://github.com/zeux/meshoptimizer
-  {
+    if (shapeData.empty()) {
+      continue;
+    }
+
+    // repack the mesh as described in https://github.com/zeux/meshoptimizer
     // 1. Generate an index buffer
-    const size_t indexCount = vertexData_.size();
+    const size_t indexCount = shapeData.size();
     std::vector<uint32_t> remap(indexCount);
     const size_t vertexCount =
-        meshopt_generateVertexRemap(remap.data(), nullptr, indexCount, vertexData_.data(), indexCount, sizeof(VertexData));
+        meshopt_generateVertexRemap(remap.data(), nullptr, indexCount, shapeData.data(), indexCount, sizeof(VertexData));
     // 2. Remap vertices
-    std::vector<VertexData> remappedVertices;
-    indexData_.resize(indexCount);
-    remappedVertices.resize(vertexCount);
-    meshopt_remapIndexBuffer(indexData_.data(), nullptr, indexCount, &remap[0]);
-    meshopt_remapVertexBuffer(remappedVertices.data(), vertexData_.data(), indexCount, sizeof(VertexData), remap.data());
-    vertexData_ = remappedVertices;
+    std::vector<uint32_t> indices(indexCount);
+    std::vector<VertexData> vertices(vertexCount);
+    meshopt_remapIndexBuffer(indices.data(), nullptr, indexCount, remap.data());
+    meshopt_remapVertexBuffer(vertices.data(), shapeData.data(), indexCount, sizeof(VertexData), remap.data());
     // 3. Optimize for the GPU vertex cache reuse and overdraw
-    meshopt_optimizeVertexCache(indexData_.data(), indexData_.data(), indexCount, vertexCount);
+    meshopt_optimizeVertexCache(indices.data(), indices.data(), indexCount, vertexCount);
     meshopt_optimizeOverdraw(
-        indexData_.data(), indexData_.data(), indexCount, &vertexData_[0].position.x, vertexCount, sizeof(VertexData), 1.05f);
-    meshopt_optimizeVertexFetch(vertexData_.data(), indexData_.data(), indexCount, vertexData_.data(), vertexCount, sizeof(VertexData));
+        indices.data(), indices.data(), indexCount, &vertices[0].position.x, vertexCount, sizeof(VertexData), 1.05f);
+    meshopt_optimizeVertexFetch(vertices.data(), indices.data(), indexCount, vertices.data(), vertexCount, sizeof(VertexData));
+
+    // bounding sphere around the center of the shape's AABB
+    vec3 minP = vertices[0].position;
+    vec3 maxP = vertices[0].position;
+    for (const VertexData& v : vertices) {
+      minP = glm::min(minP, v.position);
+      maxP = glm::max(maxP, v.position);
+    }
+    const vec3 center = 0.5f * (minP + maxP);
+    float radius = 0.0f;
+    for (const VertexData& v : vertices) {
+      radius = std::max(radius, glm::length(v.position - center));
+    }
+
+    // indices are rebased so that the whole index buffer can still be drawn with one call
+    const uint32_t baseVertex = (uint32_t)vertexData_.size();
+    shapes_.push_back({
+        .center = {center.x, center.y, center.z},
+        .radius = radius,
+        .firstIndex = (uint32_t)indexData_.size(),
+        .indexCount = (uint32_t)indexCount,
+    });
+    for (uint32_t i : indices) {
+      indexData_.push_back(baseVertex + i);
+    }
+    vertexData_.insert(vertexData_.end(), vertices.begin(), vertices.end());
   }
 
   // loop over materials
@@ -932,19 +1004,16 @@ bool loadAndCache(const char* cacheFileName) {
   const uint32_t numMaterials = (uint32_t)cachedMaterials_.size();
   const uint32_t numVertices = (uint32_t)vertexData_.size();
   const uint32_t numIndices = (uint32_t)indexData_.size();
+  const uint32_t numShapes = (uint32_t)shapes_.size();
   fwrite(&kMeshCacheVersion, sizeof(kMeshCacheVersion), 1, cacheFile);
   fwrite(&numMaterials, sizeof(numMaterials), 1, cacheFile);
   fwrite(&numVertices, sizeof(numVertices), 1, cacheFile);
   fwrite(&numIndices, sizeof(numIndices), 1, cacheFile);
+  fwrite(&numShapes, sizeof(numShapes), 1, cacheFile);
   fwrite(cachedMaterials_.data(), sizeof(CachedMaterial), numMaterials, cacheFile);
+  fwrite(shapes_.data(), sizeof(lvk::CullingShape), numShapes, cacheFile);
   fwrite(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile);
   fwrite(indexData_.data(), sizeof(uint32_t), numIndices, cacheFile);
-  const uint32_t numShapes = (uint32_t)shapeData.size();
-  fwrite(&numShapes, sizeof(numShapes), 1, cacheFile);
-  fwrite(shapeData.data(), sizeof(VertexData), numShapes, cacheFile);
-  const uint32_t numShapeVertices = (uint32_t)shapeVertexCnt_.size();
-  fwrite(&numShapeVertices, sizeof(numShapeVertices), 1, cacheFile);
-  fwrite(shapeVertexCnt_.data(), sizeof(uint32_t), numShapeVertices, cacheFile);
   return fclose(cacheFile) == 0;
 }
 
@@ -971,16 +1040,21 @@ bool loadFromCache(const char* cacheFileName) {
   uint32_t numMaterials = 0;
   uint32_t numVertices = 0;
   uint32_t numIndices = 0;
+  uint32_t numShapes = 0;
   CHECK_READ(1, fread(&numMaterials, sizeof(numMaterials), 1, cacheFile));
   CHECK_READ(1, fread(&numVertices, sizeof(numVertices), 1, cacheFile));
   CHECK_READ(1, fread(&numIndices, sizeof(numIndices), 1, cacheFile));
+  CHECK_READ(1, fread(&numShapes, sizeof(numShapes), 1, cacheFile));
   cachedMaterials_.resize(numMaterials);
-  vertexData_.resize(numVertices);
-  indexData_.resize(numIndices);
   CHECK_READ(numMaterials, fread(cachedMaterials_.data(), sizeof(CachedMaterial), numMaterials, cacheFile));
-  CHECK_READ(numVertices, fread(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile));
-  CHECK_READ(numIndices, fread(indexData_.data(), sizeof(uint32_t), numIndices, cacheFile));
+  shapes_.resize(numShapes);
+  CHECK_READ(numShapes, fread(shapes_.data(), sizeof(lvk::CullingShape), numShapes, cacheFile));
 #undef CHECK_READ
+  // do not read vertices and indices here, they will be uploaded straight from the file
+  numVertices_ = numVertices;
+  numIndices_ = numIndices;
+  cacheOffsetVertices_ = (size_t)ftell(cacheFile);
+  cacheOffsetIndices_ = cacheOffsetVertices_ + sizeof(VertexData) * numVertices;
   return true;
 }
 
@@ -988,10 +1062,13 @@ bool initModel() {
   const std::string cacheFileName = folderContentRoot + "cache.data";
 
   if (!loadFromCache(cacheFileName.c_str())) {
-    if (!LVK_VERIFY(loadAndCache(cacheFileName.c_str()))) {
+    if (!LVK_VERIFY(loadAndCache(cacheFileName.c_str()) && loadFromCache(cacheFileName.c_str()))) {
       LVK_ASSERT_MSG(false, "Cannot load 3D model");
       return false;
     }
+    // the mesh data is in the cache file now
+    vertexData_ = {};
+    indexData_ = {};
   }
 
   for (const auto& mtl : cachedMaterials_) {
@@ -1009,16 +1086,22 @@ bool initModel() {
 
   vb0_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Vertex,
                                 .storage = lvk::StorageType_Device,
-                                .size = sizeof(VertexData) * vertexData_.size(),
-                                .data = vertexData_.data(),
+                                .size = sizeof(VertexData) * numVertices_,
                                 .debugName = "Buffer: vertex"},
                                nullptr);
   ib0_ = ctx_->createBuffer({.usage = lvk::BufferUsageBits_Index,
                                 .storage = lvk::StorageType_Device,
-                                .size = sizeof(uint32_t) * indexData_.size(),
-                                .data = indexData_.data(),
+                                .size = sizeof(uint32_t) * numIndices_,
                                 .debugName = "Buffer: index"},
                                nullptr);
+  if (!ctx_->uploadFromFile(vb0_, cacheFileName.c_str(), cacheOffsetVertices_, sizeof(VertexData) * numVertices_).isOk() ||
+      !ctx_->uploadFromFile(ib0_, cacheFileName.c_str(), cacheOffsetIndices_, sizeof(uint32_t) * numIndices_).isOk()) {
+    LVK_ASSERT_MSG(false, "Cannot upload mesh data from the cache file");
+    return false;
+  }
+  if (!shapes_.empty()) {
+    culler_ = std::make_unique<lvk::GPUCuller>(*ctx_, shapes_.data(), (uint32_t)shapes_.size(), CullingView_NUM_VIEWS);
+  }
   return true;
 }
 
@@ -1153,6 +1236,7 @@ void createOffscreenFramebuffer() {
       .numMipLevels = lvk::calcNumMipLevels(w, h),
       .debugName = "Offscreen framebuffer (d)",
   };
+  // not transient: two-phase occlusion culling, which can be toggled at any time, stores the MSAA attachments between its passes
   if (kNumSamplesMSAA > 1) {
     descDepth.usage = lvk::TextureUsageBits_Attachment;
     descDepth.numSamples = kNumSamplesMSAA;
@@ -1194,6 +1278,18 @@ void createOffscreenFramebuffer() {
   }
 
   fbOffscreen_ = fb;
+  fbOffscreenEarly_ = fb;
+
+  if (kNumSamplesMSAA > 1) {
+    fbOffscreenDepthResolve_ = ctx_->createTexture({.type = lvk::TextureType_2D,
+                                                    .format = descDepth.format,
+                                                    .dimensions = {w, h},
+                                                    .usage = lvk::TextureUsageBits_Attachment | lvk::TextureUsageBits_Sampled,
+                                                    .debugName = "Offscreen framebuffer (depth resolve)"});
+    fbOffscreenEarly_.depthStencil.resolveTexture = fbOffscreenDepthResolve_;
+  }
+
+  depthPyramid_ = std::make_unique<lvk::DepthPyramid>(*ctx_, w, h);
 }
 
 void resize() {
@@ -1207,12 +1303,15 @@ void resize() {
 void showTimeGPU();
 double getCurrentTimestamp();
 
-void render(double delta, uint32_t frameIndex) {
+void render(double delta) {
   LVK_PROFILER_FUNCTION();
 
   if (!width_ && !height_)
     return;
 
+  // waits until the GPU is done with the per-frame uniform buffers of this frame
+  ctx_->beginFrame();
+
   lvk::TextureHandle nativeDrawable = ctx_->getCurrentSwapchainTexture();
   fbMain_.color[0].texture = nativeDrawable;
 
@@ -1229,6 +1328,8 @@ void render(double delta, uint32_t frameIndex) {
     ImGui::Text("N - toggle normals");
     ImGui::Text("T - toggle wireframe");
     ImGui::Text("P - show perf stats");
+    ImGui::Text("F - toggle GPU frustum culling");
+    ImGui::Text("O - toggle GPU occlusion culling");
     ImGui::End();
 
     if (!textures_[1].diffuse.empty()) {
@@ -1295,29 +1396,37 @@ void render(double delta, uint32_t frameIndex) {
       .bDrawNormals = perFrame_.bDrawNormals,
       .bDebugLines = perFrame_.bDebugLines,
   };
-  ctx_->upload(ubPerFrame_[frameIndex], &perFrame_, sizeof(perFrame_));
+  ctx_->upload(ubPerFrame_.current(), &perFrame_, sizeof(perFrame_));
 
   {
     const UniformsPerFrame perFrameShadow{
         .proj = shadowProj,
         .view = shadowView,
     };
-    ctx_->upload(ubPerFrameShadow_[frameIndex], &perFrameShadow, sizeof(perFrameShadow));
+    ctx_->upload(ubPerFrameShadow_.current(), &perFrameShadow, sizeof(perFrameShadow));
   }
 
   UniformsPerObject perObject;
 
   perObject.model = glm::scale(mat4(1.0f), vec3(0.05f));
 
-  ctx_->upload(ubPerObject_[frameIndex], &perObject, sizeof(perObject));
+  ctx_->upload(ubPerObject_.current(), &perObject, sizeof(perObject));
 
   // Command buffers (1-N per thread): create, submit and forget
 
+  const bool useCulling = enableCulling_ && culler_;
+
   // Pass 1: shadows
   if (isShadowMapDirty_) {
     lvk::ICommandBuffer& buffer = ctx_->acquireCommandBuffer();
 
-    buffer.cmdBeginRendering(renderPassShadow_, fbShadowMap_);
+    if (useCulling) {
+      const mat4 mvp = shadowProj * shadowView * perObject.model;
+      culler_->cull(buffer, glm::value_ptr(mvp), CullingView_Shadow);
+    }
+
+    buffer.cmdBeginRendering(
+        renderPassShadow_, fbShadowMap_, useCulling ? culler_->getDependencies(CullingView_Shadow) : lvk::Dependencies{});
     {
       buffer.cmdBindRenderPipeline(renderPipelineState_Shadow_);
       buffer.cmdPushDebugGroupLabel("Render Shadows", 0xff0000ff);
@@ -1327,12 +1436,16 @@ void render(double delta, uint32_t frameIndex) {
         uint64_t perFrame;
         uint64_t perObject;
       } bindings = {
-          .perFrame = ctx_->gpuAddress(ubPerFrameShadow_[frameIndex]),
-          .perObject = ctx_->gpuAddress(ubPerObject_[frameIndex]),
+          .perFrame = ctx_->gpuAddress(ubPerFrameShadow_.current()),
+          .perObject = ctx_->gpuAddress(ubPerObject_.current()),
       };
       buffer.cmdPushConstants(bindings);
       buffer.cmdBindIndexBuffer(ib0_, lvk::IndexFormat_UI32);
-      buffer.cmdDrawIndexed(static_cast<uint32_t>(indexData_.size()));
+      if (useCulling) {
+        culler_->draw(buffer, CullingView_Shadow);
+      } else {
+        buffer.cmdDrawIndexed(numIndices_);
+      }
       buffer.cmdPopDebugGroupLabel();
     }
     buffer.cmdEndRendering();
@@ -1351,14 +1464,20 @@ void render(double delta, uint32_t frameIndex) {
 
     buffer.cmdResetQueryPool(queryPoolTimestamps_, 0, GPUTimestamp_NUM_TIMESTAMPS);
 
-    GPU_TIMESTAMP(GPUTimestamp_BeginSceneRendering);
+    const bool useOcclusionCulling = useCulling && enableOcclusionCulling_ && depthPyramid_;
+    const mat4 mvp = perFrame_.proj * perFrame_.view * perObject.model;
 
-    // This will clear the framebuffer
-    buffer.cmdBeginRendering(renderPassOffscreen_, fbOffscreen_);
-    {
-      // Scene
+    // all timestamps are written every frame, disabled passes just get empty spans
+    GPU_TIMESTAMP(GPUTimestamp_BeginCullingEarly);
+    if (useCulling) {
+      // the early phase tests against the depth pyramid of the previous frame
+      culler_->cull(buffer, glm::value_ptr(mvp), CullingView_Main, useOcclusionCulling ? depthPyramid_.get() : nullptr);
+    }
+    GPU_TIMESTAMP(GPUTimestamp_EndCullingEarly);
+
+    auto drawScene = [&buffer, useCulling](bool isLate) {
       buffer.cmdBindRenderPipeline(renderPipelineState_Mesh_);
-      buffer.cmdPushDebugGroupLabel("Render Mesh", 0xff0000ff);
+      buffer.cmdPushDebugGroupLabel(isLate ? "Render Mesh (late)" : "Render Mesh", 0xff0000ff);
       buffer.cmdBindDepthState(depthState_);
       buffer.cmdBindVertexBuffer(0, vb0_, 0);
 
@@ -1367,30 +1486,76 @@ void render(double delta, uint32_t frameIndex) {
         uint64_t perObject;
         uint64_t materials;
       } bindings = {
-          .perFrame = ctx_->gpuAddress(ubPerFrame_[frameIndex]),
-          .perObject = ctx_->gpuAddress(ubPerObject_[frameIndex]),
+          .perFrame = ctx_->gpuAddress(ubPerFrame_.current()),
+          .perObject = ctx_->gpuAddress(ubPerObject_.current()),
           .materials = ctx_->gpuAddress(sbMaterials_),
       };
       buffer.cmdPushConstants(bindings);
       buffer.cmdBindIndexBuffer(ib0_, lvk::IndexFormat_UI32);
-      buffer.cmdDrawIndexed(static_cast<uint32_t>(indexData_.size()));
+      auto drawMesh = [&]() {
+        if (isLate) {
+          culler_->drawLate(buffer, CullingView_Main);
+        } else if (useCulling) {
+          culler_->draw(buffer, CullingView_Main);
+        } else {
+          buffer.cmdDrawIndexed(numIndices_);
+        }
+      };
+      drawMesh();
       if (enableWireframe_) {
         buffer.cmdBindRenderPipeline(renderPipelineState_MeshWireframe_);
-        buffer.cmdDrawIndexed(static_cast<uint32_t>(indexData_.size()));
+        drawMesh();
       }
       buffer.cmdPopDebugGroupLabel();
-
-      // Skybox
+    };
+    auto drawSkybox = [&buffer]() {
       buffer.cmdBindRenderPipeline(renderPipelineState_Skybox_);
       buffer.cmdPushDebugGroupLabel("Render Skybox", 0x00ff00ff);
       buffer.cmdBindDepthState(depthStateLEqual_);
       buffer.cmdDraw(3 * 6 * 2);
       buffer.cmdPopDebugGroupLabel();
+    };
+
+    GPU_TIMESTAMP(GPUTimestamp_BeginSceneRendering);
+
+    // This will clear the framebuffer
+    buffer.cmdBeginRendering(useOcclusionCulling ? renderPassOffscreenEarly_ : renderPassOffscreen_,
+                             useOcclusionCulling ? fbOffscreenEarly_ : fbOffscreen_,
+                             useCulling ? culler_->getDependencies(CullingView_Main) : lvk::Dependencies{});
+    {
+      drawScene(false);
+      if (!useOcclusionCulling) {
+        drawSkybox();
+      }
     }
     buffer.cmdEndRendering();
 
     GPU_TIMESTAMP(GPUTimestamp_EndSceneRendering);
 
+    GPU_TIMESTAMP(GPUTimestamp_BeginDepthPyramid);
+    if (useOcclusionCulling) {
+      depthPyramid_->build(buffer, kNumSamplesMSAA > 1 ? fbOffscreenDepthResolve_ : fbOffscreenDepth_);
+    }
+    GPU_TIMESTAMP(GPUTimestamp_EndDepthPyramid);
+
+    GPU_TIMESTAMP(GPUTimestamp_BeginCullingLate);
+    if (useOcclusionCulling) {
+      // retest everything the early phase rejected against the up-to-date pyramid
+      culler_->cullLate(buffer, glm::value_ptr(mvp), *depthPyramid_, CullingView_Main);
+    }
+    GPU_TIMESTAMP(GPUTimestamp_EndCullingLate);
+
+    GPU_TIMESTAMP(GPUTimestamp_BeginSceneRenderingLate);
+    if (useOcclusionCulling) {
+      buffer.cmdBeginRendering(renderPassOffscreenLate_, fbOffscreen_, culler_->getDependencies(CullingView_Main));
+      {
+        drawScene(true);
+        drawSkybox();
+      }
+      buffer.cmdEndRendering();
+    }
+    GPU_TIMESTAMP(GPUTimestamp_EndSceneRenderingLate);
+
     ctx_->submit(buffer);
   }
 
@@ -1459,7 +1624,7 @@ void render(double delta, uint32_t frameIndex) {
 
     GPU_TIMESTAMP(GPUTimestamp_EndPresent);
 
-    ctx_->submit(buffer, fbMain_.color[0].texture);
+    ctx_->endFrame(ctx_->submit(buffer, fbMain_.color[0].texture));
   }
 
   timestampEndRendering = getCurrentTimestamp();
@@ -1591,6 +1756,8 @@ LoadedImage loadImage(const char* fileName, int channels) {
   return img;
 }
 
+lvk::TextureHandle createTexture(const LoadedImage& img);
+
 void loadMaterial(size_t i) {
   LVK_PROFILER_FUNCTION();
 
@@ -1615,12 +1782,12 @@ void loadMaterial(size_t i) {
 
 #undef LOAD_TEX
 
-  const LoadedMaterial mtl{i, ambient, diffuse, alpha};
-
-  if (!mtl.ambient.pixels && !mtl.diffuse.pixels) {
+  if (!ambient.pixels && !diffuse.pixels) {
     // skip missing textures
     materials_[i].texDiffuse = 0;
   } else {
+    // textures are created and uploaded right here; the main thread only has to update the GPU materials
+    const LoadedMaterial mtl{i, {createTexture(ambient), createTexture(diffuse), createTexture(alpha)}};
     std::lock_guard guard(loadedMaterialsMutex_);
     loadedMaterials_.push_back(mtl);
     remainingMaterialsToLoad_.fetch_add(1u, std::memory_order_release);
@@ -1852,10 +2019,14 @@ lvk::TextureHandle createTexture(const LoadedImage& img) {
     return {};
   }
 
-  const auto it = texturesCache_.find(img.debugName);
+  {
+    std::lock_guard guard(texturesCacheMutex_);
 
-  if (it != texturesCache_.end()) {
-    return it->second;
+    const auto it = texturesCache_.find(img.debugName);
+
+    if (it != texturesCache_.end()) {
+      return it->second;
+    }
   }
 
   const bool hasCompressedTexture = kEnableCompression && img.channels == 4 && std::filesystem::exists(img.compressedFileName.c_str());
@@ -1904,6 +2075,15 @@ lvk::TextureHandle createTexture(const LoadedImage& img) {
   }
 #endif
 
+  std::lock_guard guard(texturesCacheMutex_);
+
+  // another loader thread could have created the same texture in the meantime
+  const auto it = texturesCache_.find(img.debugName);
+
+  if (it != texturesCache_.end()) {
+    return it->second;
+  }
+
   lvk::TextureHandle handle = tex;
 
   texturesCache_[img.debugName] = std::move(tex);
@@ -1926,17 +2106,13 @@ void processLoadedMaterials() {
   }
 
   {
-    MaterialTextures tex;
-
-    tex.ambient = createTexture(mtl.ambient);
-    tex.diffuse = createTexture(mtl.diffuse);
-    tex.alpha = createTexture(mtl.alpha);
+    const MaterialTextures& tex = mtl.textures;
 
     // update GPU materials
     materials_[mtl.idx].texAmbient = tex.ambient.index();
     materials_[mtl.idx].texDiffuse = tex.diffuse.index();
     materials_[mtl.idx].texAlpha = tex.alpha.index();
-    textures_[mtl.idx] = std::move(tex);
+    textures_[mtl.idx] = tex;
   }
   LVK_ASSERT(materials_[mtl.idx].texAmbient >= 0);
   LVK_ASSERT(materials_[mtl.idx].texDiffuse >= 0);
@@ -1955,7 +2131,7 @@ void showTimeGPU() {
     return double(pipelineTimestamps[begin + 1] - pipelineTimestamps[begin]) * toMS;
   };
   struct sTimeStats {
-    enum size { kNumTimelines = 5 };
+    enum size { kNumTimelines = 7 };
     struct MinMax {
       float vmin = FLT_MAX;
       float vmax = 0.0f;
@@ -1987,25 +2163,31 @@ void showTimeGPU() {
     MinMax minmax[kNumTimelines] = {};
     float avg[kNumTimelines] = {};
     const char* names[kNumTimelines] = {};
-    const vec4 colors[kNumTimelines] = {LC_Red, LC_Green, LC_Green, LC_LightBlue, LC_Red};
+    const vec4 colors[kNumTimelines] = {LC_Red, LC_Green, LC_Green, LC_Green, LC_Green, LC_LightBlue, LC_Red};
   };
   static sTimeStats stats;
 
-  const double timeScene = stats.add(1, " Scene", getTimespan(GPUTimestamp_BeginSceneRendering));
-  const double timeCompute = stats.add(2, " Compute", getTimespan(GPUTimestamp_BeginComputePass));
-  const double timePresent = stats.add(3, " Present", getTimespan(GPUTimestamp_BeginPresent));
+  const double timeCulling =
+      stats.add(1, " Culling", getTimespan(GPUTimestamp_BeginCullingEarly) + getTimespan(GPUTimestamp_BeginCullingLate));
+  const double timeScene =
+      stats.add(2, " Scene", getTimespan(GPUTimestamp_BeginSceneRendering) + getTimespan(GPUTimestamp_BeginSceneRenderingLate));
+  const double timeDepthPyramid = stats.add(3, " Depth pyramid", getTimespan(GPUTimestamp_BeginDepthPyramid));
+  const double timeCompute = stats.add(4, " Compute", getTimespan(GPUTimestamp_BeginComputePass));
+  const double timePresent = stats.add(5, " Present", getTimespan(GPUTimestamp_BeginPresent));
 
-  const double timeGPU = timeScene + timeCompute + timePresent;
+  const double timeGPU = timeCulling + timeScene + timeDepthPyramid + timeCompute + timePresent;
   stats.add(0, "GPU", timeGPU);
-  const double timeCPU = stats.add(4, "CPU", (timestampEndRendering - timestampBeginRendering) * 1000);
+  const double timeCPU = stats.add(6, "CPU", (timestampEndRendering - timestampBeginRendering) * 1000);
   stats.updateMinMax();
 
-  char text[128];
+  char text[192];
   snprintf(text,
            sizeof(text),
-           "GPU: %6.02f ms   (Scene: %.02f   Compute: %.02f   Present: %.02f)",
+           "GPU: %6.02f ms   (Culling: %.02f   Scene: %.02f   Depth pyramid: %.02f   Compute: %.02f   Present: %.02f)",
            timeGPU,
+           timeCulling,
            timeScene,
+           timeDepthPyramid,
            timeCompute,
            timePresent);
 
@@ -2171,6 +2353,12 @@ int main(int argc, char* argv[]) {
     if (key == GLFW_KEY_P && pressed) {
       showPerfStats_ = !showPerfStats_;
     }
+    if (key == GLFW_KEY_F && pressed) {
+      enableCulling_ = !enableCulling_;
+    }
+    if (key == GLFW_KEY_O && pressed) {
+      enableOcclusionCulling_ = !enableOcclusionCulling_;
+    }
     if (key == GLFW_KEY_ESCAPE && pressed)
       glfwSetWindowShouldClose(window, GLFW_TRUE);
     if (key == GLFW_KEY_W) {
@@ -2226,7 +2414,6 @@ int main(int argc, char* argv[]) {
   });
 
   double prevTime = getCurrentTimestamp();
-  uint32_t frameIndex = 0;
 
   // Main loop
   while (!glfwWindowShouldClose(window)) {
@@ -2242,9 +2429,7 @@ int main(int argc, char* argv[]) {
 
     fps_.tick(delta);
 
-    render(delta, frameIndex);
-
-    frameIndex = (frameIndex + 1) % kNumBufferedFrames;
+    render(delta);
   }
 
   // destroy all the Vulkan stuff before closing the window
@@ -2327,7 +2512,6 @@ void android_main(android_app* app) {
   fps_.printFPS_ = false;
 
   double prevTime = getCurrentTimestamp();
-  uint32_t frameIndex = 0;
 
   int events = 0;
   android_poll_source* source = nullptr;
@@ -2338,7 +2522,7 @@ void android_main(android_app* app) {
     LLOGL("FPS: %.1f\n", fps_.getFPS());
     prevTime = newTime;
     if (ctx_) {
-      render(delta, frameIndex);
+      render(delta);
       processLoadedMaterials();
     }
     if (ALooper_pollOnce(0, nullptr, &events, (void**)&source) >= 0) {
@@ -2346,7 +2530,6 @@ void android_main(android_app* app) {
         source->process(app, source);
       }
     }
-    frameIndex = (frameIndex + 1) % kNumBufferedFrames;
   } while (!app->destroyRequested);
 }
 } // extern "C"